@@ -0,0 +1,625 @@
+/*
+ * @author:	Aaron Bacher
+ * @date:	2026-10-17
+ *
+ * @brief:	Reader side of Logger module: decoding and inspecting
+ *          files written by the loggers in Logger.hpp
+ *
+ * @note:	used by logtool.cpp
+ *
+ */
+
+#ifndef LOG_READER_HPP
+#define LOG_READER_HPP
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <cstring>
+#include <algorithm>
+#include <utility>
+
+#if defined(__linux__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#define LOG_READER_USE_MMAP 1
+#else
+#define LOG_READER_USE_MMAP 0
+#endif
+
+#include "Logger.hpp"
+
+/* Converts binary log files (.blog, written by BinaryLogger) back into the layout of normal .log-files */
+class BinaryLogDecoder{
+public:
+    bool open(const std::string& path){
+        m_file.open(path, std::ios::in | std::ios::binary);
+        m_formats.clear();
+        return m_file.is_open();
+    }
+
+    // decodes records until next text line is available; returns false at end of file
+    // line does not contain trailing newline
+    bool next(std::string& line){
+
+        while(true){
+            // every session starts with magic number
+            char first;
+            if(!m_file.get(first)){
+                return false;
+            }
+            if(first == LogRecordCodec::s_magic[0]){
+                char magic[sizeof(LogRecordCodec::s_magic)];
+                magic[0] = first;
+                if(!m_file.read(magic + 1, sizeof(magic) - 1) || std::memcmp(magic, LogRecordCodec::s_magic, sizeof(magic)) != 0){
+                    m_corrupt = true;
+                    return false;
+                }
+                continue;
+            }
+            m_file.unget();
+
+            LogRecordCodec::Header header;
+            if(!m_file.read((char*)&header, sizeof(header))){
+                return false;   // incomplete record at end of file
+            }
+            m_payload.resize(header.payloadLen);
+            if(!m_file.read(m_payload.data(), header.payloadLen)){
+                return false;
+            }
+
+            switch(header.type){
+            case LogRecordCodec::SessionStart:
+                m_formats.clear();
+                break;
+
+            case LogRecordCodec::FormatDef:
+                if(header.fmtId >= m_formats.size()){
+                    m_formats.resize(header.fmtId + 1);
+                }
+                m_formats[header.fmtId] = m_payload;
+                break;
+
+            case LogRecordCodec::SessionEnd:
+                line = "------------------------------------------\n";
+                return true;
+
+            case LogRecordCodec::Entry: {
+                const char* fmt = header.fmtId < m_formats.size() ? m_formats[header.fmtId].c_str() : "<undefined format>";
+                line.clear();
+                LogEntryText::addPrefix(line, (LogLevel)header.level, "", header.timeNs, &m_timeFormatter);
+                LogRecordCodec::expand(line, fmt, m_payload.data(), m_payload.size());
+                return true;
+            }
+
+            default:
+                m_corrupt = true;
+                return false;
+            }
+        }
+    }
+
+    // true if decoding stopped because of unexpected data
+    bool isCorrupt() const { return m_corrupt; }
+
+    // layout of time stamps in decoded lines (default: same as TextLogger)
+    void setTimestampFormat(const TimestampFormat& format){
+        m_timeFormatter = LogTimeFormatter(format);
+    }
+
+private:
+    std::ifstream m_file;
+    std::vector<std::string> m_formats;     // format strings of current session, index is format id
+    std::string m_payload;
+    bool m_corrupt = false;
+    LogTimeFormatter m_timeFormatter;
+};
+
+/* Read-only view of a whole file (memory mapped where available, else read into memory) */
+class MappedFile{
+public:
+    MappedFile(){}
+
+    ~MappedFile(){
+        close();
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const std::string& path){
+        close();
+
+        #if LOG_READER_USE_MMAP
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if(fd < 0){
+            return false;
+        }
+        struct stat st;
+        if(fstat(fd, &st) != 0){
+            ::close(fd);
+            return false;
+        }
+        m_size = (std::size_t)st.st_size;
+        if(m_size > 0){
+            void* data = mmap(nullptr, m_size, PROT_READ, MAP_SHARED, fd, 0);
+            if(data == MAP_FAILED){
+                ::close(fd);
+                m_size = 0;
+                return false;
+            }
+            m_data = (const char*)data;
+        }
+        ::close(fd);    // mapping stays valid
+        #else
+        std::ifstream file(path, std::ios::in | std::ios::binary);
+        if(!file.is_open()){
+            return false;
+        }
+        m_buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        m_data = m_buffer.data();
+        m_size = m_buffer.size();
+        #endif
+
+        m_isOpen = true;
+        return true;
+    }
+
+    void close(){
+        #if LOG_READER_USE_MMAP
+        if(m_data != nullptr){
+            munmap((void*)m_data, m_size);
+        }
+        #else
+        m_buffer.clear();
+        #endif
+        m_data = nullptr;
+        m_size = 0;
+        m_isOpen = false;
+    }
+
+    bool isOpen() const { return m_isOpen; }
+    const char* data() const { return m_data; }
+    std::size_t size() const { return m_size; }
+
+private:
+    const char* m_data = nullptr;
+    std::size_t m_size = 0;
+    bool m_isOpen = false;
+
+    #if !LOG_READER_USE_MMAP
+    std::vector<char> m_buffer;
+    #endif
+};
+
+/* Reader for binary columnar files (.ccol, written by ColumnarCsvLogger)
+ * columns are accessed chunk-wise as plain arrays pointing directly into the mapped file */
+class ColumnarCsvReader{
+public:
+    struct Column{
+        ColumnarFormat::Type type;
+        std::string name;
+    };
+
+    // opens file and reads header and chunk index; returns false if file is no valid .ccol-file
+    bool open(const std::string& path){
+        m_columns.clear();
+        m_chunks.clear();
+        m_nRows = 0;
+
+        if(!m_file.open(path)){
+            return false;
+        }
+        const char* data = m_file.data();
+        std::size_t size = m_file.size();
+
+        // file header
+        std::size_t pos = sizeof(ColumnarFormat::s_fileMagic);
+        if(size < pos + 8 || std::memcmp(data, ColumnarFormat::s_fileMagic, pos) != 0){
+            return false;
+        }
+        std::uint32_t nColumns = readPod<std::uint32_t>(data, pos);
+        readPod<std::uint32_t>(data, pos);      // rows per chunk, only relevant for writer
+        for(std::uint32_t i = 0; i < nColumns; ++i){
+            if(size < pos + 3){
+                return false;
+            }
+            Column column;
+            column.type = (ColumnarFormat::Type)readPod<std::uint8_t>(data, pos);
+            std::uint16_t nameLen = readPod<std::uint16_t>(data, pos);
+            if(size < pos + nameLen || ColumnarFormat::widthOf(column.type) == 0){
+                return false;
+            }
+            column.name.assign(data + pos, nameLen);
+            pos += nameLen;
+            m_columns.push_back(column);
+        }
+        pos += ColumnarFormat::padding(pos);
+        std::size_t firstChunk = pos;
+
+        // chunk index from footer, if file has been closed properly
+        bool hasIndex = false;
+        if(size >= firstChunk + sizeof(ColumnarFormat::Footer)){
+            std::size_t footerPos = size - sizeof(ColumnarFormat::Footer);
+            ColumnarFormat::Footer footer = readPod<ColumnarFormat::Footer>(data, footerPos);
+            if(footer.magic == ColumnarFormat::s_footerMagic
+               && footer.indexOffset + footer.nChunks * sizeof(ColumnarFormat::IndexEntry) + sizeof(ColumnarFormat::Footer) == size){
+                std::size_t indexPos = footer.indexOffset;
+                for(std::uint32_t i = 0; i < footer.nChunks; ++i){
+                    ColumnarFormat::IndexEntry entry = readPod<ColumnarFormat::IndexEntry>(data, indexPos);
+                    addChunk(entry.offset);
+                }
+                hasIndex = true;
+            }
+        }
+
+        // else walk from chunk to chunk (stops at incomplete chunk)
+        if(!hasIndex){
+            m_chunks.clear();
+            m_nRows = 0;
+            pos = firstChunk;
+            while(addChunk(pos)){
+                pos = m_chunks.back().end;
+            }
+        }
+        return true;
+    }
+
+    std::size_t nColumns() const { return m_columns.size(); }
+    const Column& column(std::size_t col) const { return m_columns[col]; }
+    std::size_t nRows() const { return m_nRows; }
+    std::size_t nChunks() const { return m_chunks.size(); }
+    std::size_t chunkRows(std::size_t chunk) const { return m_chunks[chunk].nRows; }
+
+    // index of column with given name (nColumns() if there is none)
+    std::size_t findColumn(std::string_view name) const {
+        for(std::size_t i = 0; i < m_columns.size(); ++i){
+            if(m_columns[i].name == name) return i;
+        }
+        return m_columns.size();
+    }
+
+    // values of column col in chunk; T has to match the stored type (returns nullptr else)
+    template<typename T>
+    const T* chunkColumn(std::size_t chunk, std::size_t col) const {
+        if(ColumnarFormat::typeOf<T>() != m_columns[col].type){
+            return nullptr;
+        }
+        return (const T*)(m_file.data() + m_chunks[chunk].columnOffsets[col]);
+    }
+
+    // raw pointer to column data of chunk (type see column(col).type)
+    const char* chunkColumnData(std::size_t chunk, std::size_t col) const {
+        return m_file.data() + m_chunks[chunk].columnOffsets[col];
+    }
+
+    // copies whole column into out, converted to T
+    template<typename T>
+    void readColumn(std::size_t col, std::vector<T>& out) const {
+        out.clear();
+        out.reserve(m_nRows);
+        for(std::size_t c = 0; c < m_chunks.size(); ++c){
+            const char* values = chunkColumnData(c, col);
+            for(std::size_t r = 0; r < m_chunks[c].nRows; ++r){
+                out.push_back(valueAs<T>(values, r, m_columns[col].type));
+            }
+        }
+    }
+
+    // writes file as text csv, exactly as TypedCsvLogger would have written it
+    void writeCsv(std::ostream& out) const {
+        std::string line;
+        for(std::size_t i = 0; i < m_columns.size(); ++i){
+            if(i > 0) line += ",";
+            CsvFormat::appendString(line, m_columns[i].name);
+        }
+        out << line << '\n';
+
+        for(std::size_t c = 0; c < m_chunks.size(); ++c){
+            for(std::size_t r = 0; r < m_chunks[c].nRows; ++r){
+                line.clear();
+                for(std::size_t i = 0; i < m_columns.size(); ++i){
+                    if(i > 0) line += ",";
+                    appendValue(line, chunkColumnData(c, i), r, m_columns[i].type);
+                }
+                out << line << '\n';
+            }
+        }
+    }
+
+private:
+
+    struct Chunk{
+        std::size_t nRows;
+        std::vector<std::size_t> columnOffsets;
+        std::size_t end;
+    };
+
+    template<typename T>
+    static T readPod(const char* data, std::size_t& pos){
+        T value;
+        std::memcpy(&value, data + pos, sizeof(T));
+        pos += sizeof(T);
+        return value;
+    }
+
+    // reads chunk header at pos and computes column offsets; returns false if chunk is invalid or incomplete
+    bool addChunk(std::size_t pos){
+        std::size_t size = m_file.size();
+        if(pos + sizeof(ColumnarFormat::ChunkHeader) > size){
+            return false;
+        }
+        ColumnarFormat::ChunkHeader header = readPod<ColumnarFormat::ChunkHeader>(m_file.data(), pos);
+        if(header.magic != ColumnarFormat::s_chunkMagic){
+            return false;
+        }
+
+        Chunk chunk;
+        chunk.nRows = header.nRows;
+        for(const Column& column : m_columns){
+            chunk.columnOffsets.push_back(pos);
+            pos += header.nRows * ColumnarFormat::widthOf(column.type);
+            pos += ColumnarFormat::padding(pos);
+        }
+        if(pos > size){
+            return false;
+        }
+        chunk.end = pos;
+        m_nRows += chunk.nRows;
+        m_chunks.push_back(std::move(chunk));
+        return true;
+    }
+
+    template<typename T>
+    static T valueAs(const char* values, std::size_t row, ColumnarFormat::Type type){
+        switch(type){
+        case ColumnarFormat::Int8:   return (T)((const std::int8_t*)values)[row];
+        case ColumnarFormat::Int16:  return (T)((const std::int16_t*)values)[row];
+        case ColumnarFormat::Int32:  return (T)((const std::int32_t*)values)[row];
+        case ColumnarFormat::Int64:  return (T)((const std::int64_t*)values)[row];
+        case ColumnarFormat::UInt8:  return (T)((const std::uint8_t*)values)[row];
+        case ColumnarFormat::UInt16: return (T)((const std::uint16_t*)values)[row];
+        case ColumnarFormat::UInt32: return (T)((const std::uint32_t*)values)[row];
+        case ColumnarFormat::UInt64: return (T)((const std::uint64_t*)values)[row];
+        case ColumnarFormat::Float:  return (T)((const float*)values)[row];
+        case ColumnarFormat::Double: return (T)((const double*)values)[row];
+        case ColumnarFormat::Bool:   return (T)((const bool*)values)[row];
+        }
+        return T();
+    }
+
+    static void appendValue(std::string& out, const char* values, std::size_t row, ColumnarFormat::Type type){
+        switch(type){
+        case ColumnarFormat::Int8:   CsvFormat::appendValue(out, ((const std::int8_t*)values)[row]); break;
+        case ColumnarFormat::Int16:  CsvFormat::appendValue(out, ((const std::int16_t*)values)[row]); break;
+        case ColumnarFormat::Int32:  CsvFormat::appendValue(out, ((const std::int32_t*)values)[row]); break;
+        case ColumnarFormat::Int64:  CsvFormat::appendValue(out, ((const std::int64_t*)values)[row]); break;
+        case ColumnarFormat::UInt8:  CsvFormat::appendValue(out, ((const std::uint8_t*)values)[row]); break;
+        case ColumnarFormat::UInt16: CsvFormat::appendValue(out, ((const std::uint16_t*)values)[row]); break;
+        case ColumnarFormat::UInt32: CsvFormat::appendValue(out, ((const std::uint32_t*)values)[row]); break;
+        case ColumnarFormat::UInt64: CsvFormat::appendValue(out, ((const std::uint64_t*)values)[row]); break;
+        case ColumnarFormat::Float:  CsvFormat::appendValue(out, ((const float*)values)[row]); break;
+        case ColumnarFormat::Double: CsvFormat::appendValue(out, ((const double*)values)[row]); break;
+        case ColumnarFormat::Bool:   CsvFormat::appendValue(out, ((const bool*)values)[row]); break;
+        }
+    }
+
+    MappedFile m_file;
+    std::vector<Column> m_columns;
+    std::vector<Chunk> m_chunks;
+    std::size_t m_nRows = 0;
+};
+
+/* Reader for text logs written through MappedLogSink (TextLogger::enableMappedOutput)
+ * after a crash the file may contain preallocated zero bytes and entries which were only partly copied;
+ * only complete lines are returned: the part of a line after its last NUL byte, lines consisting of NUL bytes only are skipped */
+class CompleteLineReader{
+public:
+    CompleteLineReader(){}
+
+    bool open(const std::string& path){
+        m_pos = 0;
+        m_skippedBytes = 0;
+        return m_file.open(path);
+    }
+
+    // returns next complete line (without newline), false at end of file
+    bool next(std::string_view& line){
+        const char* data = m_file.data();
+        std::size_t size = m_file.size();
+
+        while(m_pos < size){
+            const char* begin = data + m_pos;
+            const char* newline = (const char*)std::memchr(begin, '\n', size - m_pos);
+            if(newline == nullptr){
+                // unterminated rest of file: incomplete entry
+                m_skippedBytes += size - m_pos;
+                m_pos = size;
+                return false;
+            }
+            m_pos = (std::size_t)(newline - data) + 1;
+
+            std::string_view piece(begin, (std::size_t)(newline - begin));
+            std::size_t lastNul = piece.find_last_of('\0');
+            if(lastNul != std::string_view::npos){
+                m_skippedBytes += lastNul + 1;
+                piece.remove_prefix(lastNul + 1);
+                if(piece.empty()){
+                    // zeros only (gap of an entry that was never written)
+                    m_skippedBytes += 1;
+                    continue;
+                }
+            }
+            line = piece;
+            return true;
+        }
+        return false;
+    }
+
+    // bytes of incomplete entries and zero padding skipped so far
+    std::size_t skippedBytes() const { return m_skippedBytes; }
+
+private:
+    MappedFile m_file;
+    std::size_t m_pos = 0;
+    std::size_t m_skippedBytes = 0;
+};
+
+/* Reader for compressed log files (.lz4, written by LogFileSink with compression enabled)
+ * frames are found through the index, so a time range can be read without decompressing the whole file */
+class CompressedLogReader{
+public:
+    CompressedLogReader(){}
+
+    bool open(const std::string& path){
+        m_file.close();
+        m_file.clear();
+        m_file.open(path, std::ios::in | std::ios::binary);
+        if(!m_file.is_open()){
+            return false;
+        }
+
+        std::error_code ec;
+        std::uint64_t fileSize = (std::uint64_t)std::filesystem::file_size(path, ec);
+        if(ec){
+            return false;
+        }
+
+        std::uint64_t dataEnd;
+        m_hasFooter = LogCompression::readIndex(m_file, fileSize, m_index, dataEnd);
+
+        // anything else than an empty file has to start with a frame
+        return fileSize == 0 || !m_index.empty();
+    }
+
+    std::size_t nFrames() const { return m_index.size(); }
+
+    // false if file has not been closed properly (index has been rebuilt from frame headers)
+    bool hasFooter() const { return m_hasFooter; }
+
+    const LogCompression::IndexEntry& frame(std::size_t i) const { return m_index[i]; }
+
+    // decompresses frame i into out; returns false if frame is corrupt
+    bool readFrame(std::size_t i, std::string& out){
+        LogCompression::FrameHeader header;
+        m_file.clear();
+        m_file.seekg((std::streamoff)m_index[i].offset);
+        if(!m_file.read((char*)&header, sizeof(header)) || header.magic != LogCompression::s_frameMagic){
+            return false;
+        }
+
+        out.resize(header.rawSize);
+        if(header.flags & LogCompression::Stored){
+            return header.compressedSize == header.rawSize && (bool)m_file.read(out.data(), header.rawSize);
+        }
+
+        m_compressed.resize(header.compressedSize);
+        if(!m_file.read(m_compressed.data(), header.compressedSize)){
+            return false;
+        }
+        return LogCompression::decompress(m_compressed.data(), m_compressed.size(), out.data(), out.size());
+    }
+
+    // writes all frames containing entries written between fromNs and toNs (unix time in ns, inclusive)
+    // returns false if a corrupt frame has been found
+    bool write(std::ostream& out, std::int64_t fromNs = INT64_MIN, std::int64_t toNs = INT64_MAX){
+        std::string data;
+        for(std::size_t i = 0; i < m_index.size(); ++i){
+            if(m_index[i].lastTimeNs < fromNs || m_index[i].firstTimeNs > toNs){
+                continue;
+            }
+            if(!readFrame(i, data)){
+                return false;
+            }
+            out.write(data.data(), (std::streamsize)data.size());
+        }
+        return true;
+    }
+
+private:
+    std::ifstream m_file;
+    std::vector<LogCompression::IndexEntry> m_index;
+    std::string m_compressed;
+    bool m_hasFooter = false;
+};
+
+/* Reader for .log and .csv files with time index (<file>.idx, see Logger::enableTimeIndex)
+ * a time range is found by binary search over the index points and streamed directly from the mapped file;
+ * boundaries are at index granularity: the slice may contain up to one index interval of entries before
+ * and after the range, entries which are written out of order by more than one interval may be missed */
+class IndexedLogReader{
+public:
+    IndexedLogReader(){}
+
+    // returns false if log file or index cannot be opened or index is not valid
+    bool open(const std::string& path){
+        m_points.clear();
+        m_isCsv = path.size() > 4 && path.substr(path.size()-4, 4) == ".csv";
+        if(!m_file.open(path)){
+            return false;
+        }
+
+        MappedFile index;
+        if(!index.open(LogTimeIndex::pathOf(path)) || index.size() < sizeof(LogTimeIndex::s_magic)
+           || std::memcmp(index.data(), LogTimeIndex::s_magic, sizeof(LogTimeIndex::s_magic)) != 0){
+            m_file.close();
+            return false;
+        }
+
+        // trailing partly written point is ignored; points behind the end of the log (data not yet flushed) as well
+        std::size_t nPoints = (index.size() - sizeof(LogTimeIndex::s_magic)) / sizeof(LogTimeIndex::Point);
+        m_points.resize(nPoints);
+        if(nPoints > 0){
+            std::memcpy(m_points.data(), index.data() + sizeof(LogTimeIndex::s_magic), nPoints * sizeof(LogTimeIndex::Point));
+        }
+        while(!m_points.empty() && m_points.back().offset > m_file.size()){
+            m_points.pop_back();
+        }
+        return true;
+    }
+
+    std::size_t nPoints() const { return m_points.size(); }
+
+    const LogTimeIndex::Point& point(std::size_t i) const { return m_points[i]; }
+
+    // byte range [begin, end) of log file holding entries written between fromNs and toNs (unix time in ns, inclusive)
+    std::pair<std::uint64_t, std::uint64_t> range(std::int64_t fromNs = INT64_MIN, std::int64_t toNs = INT64_MAX) const {
+        // begin: last point with only older entries in front of it
+        auto first = std::lower_bound(m_points.begin(), m_points.end(), fromNs, [](const LogTimeIndex::Point& point, std::int64_t t){
+            return point.timeNs < t;
+        });
+        std::uint64_t begin = first == m_points.begin() ? 0 : (first - 1)->offset;
+
+        // end: first point with a newer entry in front of it
+        auto last = std::upper_bound(m_points.begin(), m_points.end(), toNs, [](std::int64_t t, const LogTimeIndex::Point& point){
+            return t < point.timeNs;
+        });
+        std::uint64_t end = last == m_points.end() ? m_file.size() : last->offset;
+
+        return {begin, std::max(begin, end)};
+    }
+
+    // writes entries between fromNs and toNs (see range()); csv files get their header line in front
+    void write(std::ostream& out, std::int64_t fromNs = INT64_MIN, std::int64_t toNs = INT64_MAX) const {
+        auto [begin, end] = range(fromNs, toNs);
+        if(begin == end){
+            return;
+        }
+        if(m_isCsv && begin > 0){
+            const char* newline = (const char*)std::memchr(m_file.data(), '\n', m_file.size());
+            if(newline != nullptr && (std::uint64_t)(newline - m_file.data()) < begin){
+                out.write(m_file.data(), newline - m_file.data() + 1);
+            }
+        }
+        out.write(m_file.data() + begin, (std::streamsize)(end - begin));
+    }
+
+private:
+    MappedFile m_file;
+    std::vector<LogTimeIndex::Point> m_points;
+    bool m_isCsv = false;
+};
+
+#endif // LOG_READER_HPP
@@ -18,7 +18,6 @@
 #include <string>
 #include <fstream>
 #include <vector>
-#include <queue>
 #include <memory>
 #include <ctime>
 
@@ -26,13 +25,58 @@
 
 #include <unistd.h>
 #include <filesystem>
+#include <string_view>
+#include <chrono>
+#include <cstdint>
+#include <atomic>
+#include <cstring>
+#include <cstdio>
+#include <type_traits>
+#include <charconv>
+#include <cmath>
+#include <cctype>
+#include <tuple>
+#include <array>
+#include <deque>
+#include <functional>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/file.h>
+#include <sched.h>
+#include <cerrno>
+#include <csignal>
+#include <exception>
+#if __has_include(<linux/io_uring.h>) && defined(__NR_io_uring_setup)
+#include <linux/io_uring.h>
+#define LOGGER_HAS_IO_URING 1
+#endif
+#endif
+
+// io_uring is used for asynchronous file output if kernel headers provide it (see LogAsyncFile)
+#ifndef LOGGER_HAS_IO_URING
+#define LOGGER_HAS_IO_URING 0
+#endif
 
 #define ENABLE_MULTITHREADING 1
 
+// most verbose level which gets compiled in at all; calls of LOG_<LEVEL> macros (and log<LogLevel::...>)
+// above this level compile to nothing and their arguments are never evaluated
+// e.g. compile with -DLOGGER_COMPILE_LEVEL=LogLevel::Info to remove all debug logging from release builds
+#ifndef LOGGER_COMPILE_LEVEL
+#define LOGGER_COMPILE_LEVEL LogLevel::Debug
+#endif
+
 #if ENABLE_MULTITHREADING
 #include <mutex>
 #include <thread>
 #include <chrono>
+#include <condition_variable>
+#include <future>
 
 // used by everybody (each class) which prints to console
 // can (should) be used also outside this header file
@@ -41,555 +85,7448 @@ inline std::mutex consoleMutex;
 
 namespace fs = std::filesystem;
 
+// selection from https://www.ibm.com/docs/en/cognos-analytics/10.2.2?topic=SSEP7J_10.2.2/com.ibm.swg.ba.cognos.ug_rtm_wb.10.2.2.doc/c_n30e74.html
+enum LogLevel {
+    Error,
+    Warning,
+    Info,
+    Debug
+};
+
+inline bool logLevelToStr(std::string& str, LogLevel logLevel){
+    switch (logLevel)
+    {
+    case LogLevel::Error:
+        str = "ERROR";
+        return true;
+    case LogLevel::Warning:
+        str = "WARNING";
+        return true;
+    case LogLevel::Info:
+        str = "INFO";
+        return true;
+    case LogLevel::Debug:
+        str = "DEBUG";
+        return true;
+    }
+
+    str = "UNDEFINED";
+    return false;
+}
+
+
+enum class TimePrecision {
+    Seconds,
+    Milliseconds,
+    Microseconds,
+    Nanoseconds
+};
+
+enum class TimeZone {
+    Local,
+    UTC
+};
+
+// layout of time stamps in text logs
+struct TimestampFormat{
+    std::string pattern = "%d-%m-%Y %H:%M:%S";          // strftime pattern for everything down to seconds
+    TimePrecision precision = TimePrecision::Seconds;   // sub-second digits appended as ".123" etc.
+    TimeZone timeZone = TimeZone::Local;
+};
+
+// how text loggers write entries: "<time> - <LEVEL>:   msg key=value", one json object per line or logfmt
+enum class LogLayout {
+    Text,
+    JsonLines,
+    Logfmt
+};
+
+/* Formats time stamps of log entries
+ * the expensive part (localtime_r/gmtime_r + strftime) is done only once per second and thread,
+ * afterwards only the sub-second digits get appended */
+class LogTimeFormatter{
+public:
+    LogTimeFormatter(const TimestampFormat& format = TimestampFormat())
+        :m_format(format), m_id(s_nextId.fetch_add(1, std::memory_order_relaxed))
+    {}
+
+    // current wall clock time in nanoseconds since epoch
+    static std::int64_t nowNs(){
+        #ifdef __linux__
+        struct timespec ts;
+        clock_gettime(CLOCK_REALTIME, &ts);
+        return (std::int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+        #else
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+        #endif
+    }
+
+    // appends formatted timeNs (nanoseconds since epoch) to out
+    void append(std::string& out, std::int64_t timeNs) const {
+        std::int64_t second = timeNs / 1000000000;
+        std::int64_t subSecond = timeNs % 1000000000;
+        if(subSecond < 0){
+            subSecond += 1000000000;
+            --second;
+        }
+
+        // look up (or create) formatted second in cache of calling thread
+        CacheLine& line = lookup(second);
+        out.append(line.text, line.len);
+
+        switch(m_format.precision){
+        case TimePrecision::Seconds:
+            break;
+        case TimePrecision::Milliseconds:
+            appendFraction(out, subSecond / 1000000, 3);
+            break;
+        case TimePrecision::Microseconds:
+            appendFraction(out, subSecond / 1000, 6);
+            break;
+        case TimePrecision::Nanoseconds:
+            appendFraction(out, subSecond, 9);
+            break;
+        }
+    }
+
+    const TimestampFormat& getFormat() const { return m_format; }
+
+private:
+
+    struct CacheLine{
+        std::uint64_t formatterId = 0;
+        std::int64_t second = 0;
+        char text[64];
+        std::size_t len = 0;
+    };
+
+    static constexpr std::size_t s_cacheSize = 4;
+
+    CacheLine& lookup(std::int64_t second) const {
+        thread_local CacheLine cache[s_cacheSize];
+        thread_local std::size_t nextVictim = 0;
+
+        for(std::size_t i = 0; i < s_cacheSize; ++i){
+            if(cache[i].formatterId == m_id && cache[i].second == second){
+                return cache[i];
+            }
+        }
+
+        // replace line which was used for this formatter before (if any), else round robin
+        std::size_t victim = s_cacheSize;
+        for(std::size_t i = 0; i < s_cacheSize; ++i){
+            if(cache[i].formatterId == m_id){
+                victim = i;
+                break;
+            }
+        }
+        if(victim == s_cacheSize){
+            victim = nextVictim;
+            nextVictim = (nextVictim + 1) % s_cacheSize;
+        }
+
+        CacheLine& line = cache[victim];
+        time_t rawTime = (time_t)second;
+        struct tm timeinfo;
+        #ifdef _WIN32
+        if(m_format.timeZone == TimeZone::UTC) gmtime_s(&timeinfo, &rawTime);
+        else localtime_s(&timeinfo, &rawTime);
+        #else
+        if(m_format.timeZone == TimeZone::UTC) gmtime_r(&rawTime, &timeinfo);
+        else localtime_r(&rawTime, &timeinfo);
+        #endif
+        line.len = strftime(line.text, sizeof(line.text), m_format.pattern.c_str(), &timeinfo);
+        line.formatterId = m_id;
+        line.second = second;
+        return line;
+    }
+
+    static void appendFraction(std::string& out, std::int64_t value, int digits){
+        char buffer[10];
+        buffer[0] = '.';
+        for(int i = digits; i > 0; --i){
+            buffer[i] = (char)('0' + value % 10);
+            value /= 10;
+        }
+        out.append(buffer, digits + 1);
+    }
+
+    TimestampFormat m_format;
+    std::uint64_t m_id;         // unique per formatter, identifies cache lines
+
+    inline static std::atomic<std::uint64_t> s_nextId{1};
+};
+
+// formatter used if nothing else is specified (layout of .log-files so far)
+inline const LogTimeFormatter& defaultTimeFormatter(){
+    static const LogTimeFormatter formatter;
+    return formatter;
+}
+
 class LogEntry{
 public:
 
-    LogEntry(const std::string& entry)
+    LogEntry(std::string_view entry)
         :m_entry(entry)
     {}
 
+    virtual ~LogEntry(){}
+
+    // re-initializes entry (used by LogEntryPool); keeps capacity of string, so no allocation is needed
+    void assign(std::string_view entry){
+        m_entry.assign(entry.data(), entry.size());
+    }
+
     virtual void constructEntry() {
         // nothing to do here, just for derived classes to implement something
     }
 
-    std::string getEntry() { return m_entry; }
+    // used by sinks to decide about flushing; plain entries (e.g. csv rows) count as Info
+    virtual LogLevel getLogLevel() const { return LogLevel::Info; }
+
+    // layout used by constructEntry (only of interest for text entries)
+    virtual void setLayout(LogLayout layout){ (void)layout; }
+
+    // time stamp of entry in ns since epoch (0 -> entry has none, e.g. csv rows)
+    virtual std::int64_t getTimeNs() const { return 0; }
+
+    // barriers are not written, but mark up to where entries have to be flushed or synced (see LogEntryBarrier)
+    virtual bool isBarrier() const { return false; }
+
+    const std::string& getEntry() const { return m_entry; }
+
+    // time the entry has been handed over to the queue (steady clock, ns; only set if instrumentation is enabled)
+    void setQueuedAt(std::uint64_t timeNs){ m_queuedAtNs = timeNs; }
+    std::uint64_t getQueuedAt() const { return m_queuedAtNs; }
 protected:
 
     LogEntry(){}    // default constructor can only be called by derived classes
 
     std::string m_entry;
+    std::uint64_t m_queuedAtNs = 0;
 };
 
-// logger class
-class Logger{
+// called when a flush or sync request has been satisfied (see Logger::sync); false -> writing or fdatasync failed
+using LogDurabilityCallback = std::function<void(bool)>;
+
+/* Queued by Logger::flush and Logger::sync behind the entries logged so far; whoever writes the entries hands
+ * the request to the sink when reaching it (see Logger::writeEntry) */
+class LogEntryBarrier : public LogEntry{
 public:
-    Logger(bool enableConsolePrinting=false)
-        :m_enableConsolePrinting(enableConsolePrinting), m_isHandledByThreader(false)
+    LogEntryBarrier(bool sync, LogDurabilityCallback done)
+        :m_isSync(sync), m_done(std::move(done))
     {}
 
-    ~Logger(){
-        m_logFile.close();
-
-        // remove logfile from s_openLogFiles
-        s_openLogFiles.erase(std::find(s_openLogFiles.begin(), s_openLogFiles.end(), m_logFilePath));
+    // dropped (queue full) or never written: request failed
+    ~LogEntryBarrier(){
+        if(m_done){
+            m_done(false);
+        }
     }
 
-    bool isHandledByThreader() { return m_isHandledByThreader; }
+    bool isBarrier() const override { return true; }
 
-protected:
+    bool isSync() const { return m_isSync; }
 
-    bool m_enableConsolePrinting;
+    LogDurabilityCallback takeCallback(){
+        LogDurabilityCallback done = std::move(m_done);
+        m_done = nullptr;
+        return done;
+    }
 
-    std::string m_logFilePath;
-    std::ofstream m_logFile;
+private:
+    bool m_isSync;
+    LogDurabilityCallback m_done;
+};
 
-    // method to intialize file
-    void setup(std::string logFileName, bool logFileNameIsAbsolutePath){
+/* Latency distribution with ~6% resolution: 16 buckets per power of two (values in ns) */
+class LatencyHistogram{
+public:
+    static constexpr int s_subBits = 4;
+    static constexpr int s_nBuckets = 64 << s_subBits;
 
-        std::string logFileDir;
-        std::string dirSeparator;
-        
-        #ifdef __linux__
-        dirSeparator = std::string("/");
-        #elif _WIN32
-        dirSeparator = std::string("\\");
-        #endif
+    LatencyHistogram()
+        :m_counts(s_nBuckets, 0)
+    {}
 
-        if(!logFileNameIsAbsolutePath){
-            // compose logFile path
-            char cwd[256];
-            getcwd(cwd, 256);
+    void add(std::uint64_t ns, std::uint64_t count=1){
+        m_counts[bucketOf(ns)] += count;
+        m_total += count;
+        if(ns > m_max){
+            m_max = ns;
+        }
+    }
 
-            logFileDir = std::string(cwd) + dirSeparator + "log";
-            m_logFilePath = logFileDir + dirSeparator + logFileName;
+    void merge(const LatencyHistogram& other){
+        for(int i = 0; i < s_nBuckets; ++i){
+            m_counts[i] += other.m_counts[i];
         }
-        else{
-            m_logFilePath = logFileName;
-            std::size_t found = logFileName.rfind(dirSeparator);
-            if(found != std::string::npos){
-                logFileDir = logFileName.substr(0, found);
-            }
-            else{
-                logFileDir = dirSeparator;
-            }
+        m_total += other.m_total;
+        if(other.m_max > m_max){
+            m_max = other.m_max;
         }
+    }
 
-        // check that no other logger is already writing to that file
-        if (std::find(s_openLogFiles.begin(), s_openLogFiles.end(), m_logFilePath) != s_openLogFiles.end()){
-            std::string errMsg = "-----------\nERROR: log-file (" + m_logFilePath + ") already in use by other Logger!\n-----------";
-            printToConsole(errMsg);
+    // upper bound of bucket containing given quantile (0..1)
+    std::uint64_t percentile(double quantile) const {
+        if(m_total == 0){
+            return 0;
         }
-        else{
-            s_openLogFiles.push_back(m_logFilePath);
+        std::uint64_t rank = (std::uint64_t)(quantile * (double)(m_total - 1)) + 1;
+        std::uint64_t seen = 0;
+        for(int i = 0; i < s_nBuckets; ++i){
+            seen += m_counts[i];
+            if(seen >= rank){
+                return std::min(upperBound(i), m_max);
+            }
         }
+        return m_max;
+    }
 
-        // check if log directory exists and create it if not
-        if(!fs::exists(logFileDir)){
-            fs::create_directory(logFileDir);
-        }
+    std::uint64_t count() const { return m_total; }
+    std::uint64_t max() const { return m_max; }
+    std::uint64_t bucketCount(int bucket) const { return m_counts[bucket]; }
 
-        if(m_logFilePath.substr(m_logFilePath.size()-4, 4) == ".log"){          // append mode
-            m_logFile.open(m_logFilePath, std::ios::out | std::ios::app);
-        }
-        else if(m_logFilePath.substr(m_logFilePath.size()-4, 4) == ".csv"){     // delete file content and write afterwards
-            m_logFile.open(m_logFilePath, std::ios::out);
-        }
-        else{
-            std::string errMsg = "-----------\nERROR: Unknown log-file type!\n-----------";
-            printToConsole(errMsg);
+    static int bucketOf(std::uint64_t ns){
+        if(ns < (1u << s_subBits)){
+            return (int)ns;
         }
+        int msb = 63 - __builtin_clzll(ns);
+        int sub = (int)((ns >> (msb - s_subBits)) & ((1u << s_subBits) - 1));
+        return ((msb - s_subBits + 1) << s_subBits) + sub;
+    }
 
-        // check if logfile creation and opening as been successful
-        if(!m_logFile.is_open()){
-            std::string errMsg = "-----------\nERROR: Could not open log-file! " + m_logFilePath + "\n-----------";
-            printToConsole(errMsg);
-        }
-        else{
-            std::string infoMsg = "Logging to file " + m_logFilePath;
-            printToConsole(infoMsg);
+    static std::uint64_t upperBound(int bucket){
+        if(bucket < (1 << s_subBits)){
+            return (std::uint64_t)bucket;
         }
+        int msb = (bucket >> s_subBits) + s_subBits - 1;
+        std::uint64_t sub = (std::uint64_t)(bucket & ((1 << s_subBits) - 1));
+        return ((((std::uint64_t)1 << s_subBits) + sub + 1) << (msb - s_subBits)) - 1;
     }
 
-    // handle printing to console with time stamps etc.
-    void printToConsole(const std::string& msg){
+private:
+    std::vector<std::uint64_t> m_counts;
+    std::uint64_t m_total = 0;
+    std::uint64_t m_max = 0;
+};
 
-        // note: I used to differentiate between error messages (then printed with cerr <<) and non-error messages (printed with cout <<)
-        // but as this might affect printing order (which was initially the objective of differentiating), I removed it
-        #if ENABLE_MULTITHREADING
-        consoleMutex.lock();
-        #endif
-        std::cout << msg << std::endl;
-        #if ENABLE_MULTITHREADING
-        consoleMutex.unlock();
-        #endif
+/* LatencyHistogram which may be filled by several threads at once (relaxed atomic counters) */
+class AtomicLatencyHistogram{
+public:
+    AtomicLatencyHistogram()
+        :m_counts(std::make_unique<std::atomic<std::uint64_t>[]>(LatencyHistogram::s_nBuckets))
+    {
+        for(int i = 0; i < LatencyHistogram::s_nBuckets; ++i){
+            m_counts[i].store(0, std::memory_order_relaxed);
+        }
     }
 
-    // prints entry to logfile
-    void printToFile(const std::string& msg){
+    void add(std::uint64_t ns){
+        m_counts[LatencyHistogram::bucketOf(ns)].fetch_add(1, std::memory_order_relaxed);
+        std::uint64_t max = m_max.load(std::memory_order_relaxed);
+        while(ns > max && !m_max.compare_exchange_weak(max, ns, std::memory_order_relaxed)){}
+    }
 
-        // print to file
-        m_logFile << msg << std::endl;
+    LatencyHistogram snapshot() const {
+        LatencyHistogram histogram;
+        for(int i = 0; i < LatencyHistogram::s_nBuckets; ++i){
+            std::uint64_t count = m_counts[i].load(std::memory_order_relaxed);
+            if(count > 0){
+                histogram.add(std::min(LatencyHistogram::upperBound(i), m_max.load(std::memory_order_relaxed)), count);
+            }
+        }
+        return histogram;
     }
 
 private:
+    std::unique_ptr<std::atomic<std::uint64_t>[]> m_counts;
+    std::atomic<std::uint64_t> m_max{0};
+};
 
-    bool m_isHandledByThreader;       // defines if logger should work on its own (false) or if logging is done by LogThreader in separate thread (true)
+// defines when buffered entries of a LogFileSink are actually written to file
+struct FlushPolicy{
+    std::size_t bufferSize = 0;                 // bytes collected before writing; 0 -> every entry gets written immediately
+    std::chrono::milliseconds maxDelay{1000};   // buffered entries are written at the latest after this time (checked on writes and by LogThreader)
+    int flushLevel = LogLevel::Error;           // entries with this level or a more severe one are written immediately (-1 -> never)
+    int syncLevel = -1;                         // entries with this level or a more severe one are made durable (fdatasync; -1 -> never)
+                                                // threaded loggers sync once per batch, so entries written together share one fdatasync
+};
 
-    inline static std::vector<std::string> s_openLogFiles; // holds paths to all currently open log files in order to make sure that not two loggers are writing to same one
+// asynchronous file output (see Logger::enableAsyncIo)
+struct AsyncIoPolicy{
+    std::size_t depth = 4;                          // writes in flight per file; writing thread only waits if all are
+    std::size_t bufferSize = 256 << 10;             // bytes per write buffer (larger writes are split)
+    std::chrono::milliseconds syncInterval{0};      // fdatasync at most this often while data is written (0 -> never)
+    bool useUring = true;                           // false -> always pwrite on LogIoPool threads
+};
 
-    // construct entry, give command to write to console and/or file
-    virtual void print(std::unique_ptr<LogEntry> entry, bool enforceConsoleWriting=false) = 0;
+struct SinkStats{
+    std::uint64_t entries = 0;      // entries passed to sink
+    std::uint64_t bytes = 0;        // bytes written to file
+    std::uint64_t syscalls = 0;     // write calls issued
+    std::uint64_t flushes = 0;      // times the buffer has been handed to the OS
+    std::uint64_t rotations = 0;    // times a new file has been started because of rotation policy
+    std::uint64_t uncompressedBytes = 0;    // bytes passed to compression (if enabled)
+    std::uint64_t syncs = 0;        // fdatasync calls completed (see Logger::sync, FlushPolicy::syncLevel, AsyncIoPolicy::syncInterval)
+    std::uint64_t stalls = 0;       // times writing had to wait for a free buffer (asynchronous output only)
+    std::uint64_t errors = 0;       // failed writes (asynchronous output only)
 
+    // write calls that would have been necessary with one write per entry, minus the ones actually issued
+    std::uint64_t syscallsSaved() const { return entries > syscalls ? entries - syscalls : 0; }
+};
 
-#if ENABLE_MULTITHREADING
-public:
-    // removes first item in queue and passes it to caller (e.g. LogThreader) (returns nullptr if queue empty)
-    std::unique_ptr<LogEntry> getQueueItem(){
+// snapshot of what a logger has done so far (see Logger::getStats)
+struct LoggerStats{
+    std::uint64_t enqueued = 0;         // entries handed over to queue (written + waiting + dropped)
+    std::uint64_t written = 0;          // entries taken from queue and written by LogThreader
+    std::uint64_t droppedNewest = 0;    // see Logger::getDroppedNewestCount
+    std::uint64_t droppedOldest = 0;    // see Logger::getDroppedOldestCount
+    std::size_t queueDepth = 0;         // entries currently waiting
+    std::size_t queueHighWater = 0;     // most entries seen waiting at once (per producing thread with thread buffers)
+    LatencyHistogram enqueueLatency;    // time a log call spent handing entry over to queue (only with instrumentation)
+    LatencyHistogram endToEndLatency;   // time from handing over until written (only with instrumentation)
+    SinkStats sink;
+};
 
-        std::unique_ptr<LogEntry> entry;
+/* Block compression of log files (used by LogFileSink if compression is enabled)
+ * file layout: frames, then index and footer (written on close)
+ *   frame:   header (magic, raw size, compressed size, flags, time of first and last entry), compressed data
+ *   index:   per frame its offset and time range, so that any time range can be read without touching the rest
+ * every frame is compressed on its own in LZ4 block format; a file without footer (crash) can still be read frame by frame */
+struct LogCompression{
+    static constexpr std::uint32_t s_frameMagic = 0x31465A4C;     // "LZF1"
+    static constexpr std::uint32_t s_footerMagic = 0x58445A4C;    // "LZDX"
 
-        m_queueMutex.lock();
-        if(m_logEntries.size() == 0){
-            return std::unique_ptr<LogEntry>(nullptr);
-        }
-        else{
-            entry = move(m_logEntries.front());
-            m_logEntries.pop();
+    enum Flags : std::uint32_t {
+        Stored = 1      // data did not get smaller and is stored as it is
+    };
+
+    struct FrameHeader{
+        std::uint32_t magic;
+        std::uint32_t rawSize;
+        std::uint32_t compressedSize;
+        std::uint32_t flags;
+        std::int64_t firstTimeNs;
+        std::int64_t lastTimeNs;
+    };
+
+    struct IndexEntry{
+        std::uint64_t offset;
+        std::int64_t firstTimeNs;
+        std::int64_t lastTimeNs;
+    };
+
+    struct Footer{
+        std::uint64_t indexOffset;
+        std::uint32_t nFrames;
+        std::uint32_t magic;
+    };
+
+    // compresses src into out (LZ4 block format: greedy matching with a hash table of 4-byte sequences)
+    static void compress(const char* src, std::size_t size, std::string& out){
+        out.clear();
+
+        const std::size_t minMatch = 4;
+        const std::size_t lastLiterals = 5;     // format requires last 5 bytes to be literals ...
+        const std::size_t matchLimit = 12;      // ... and last match to start at least 12 bytes before end
+
+        std::size_t anchor = 0;
+        if(size > matchLimit){
+            std::uint32_t table[1 << 12] = {};
+            std::size_t pos = 0;
+            std::size_t limit = size - matchLimit;
+
+            while(pos < limit){
+                std::uint32_t sequence = read32(src + pos);
+                std::uint32_t hash = (sequence * 2654435761u) >> 20;
+                std::size_t ref = table[hash];
+                table[hash] = (std::uint32_t)pos;
+
+                if(ref >= pos || pos - ref > 65535 || read32(src + ref) != sequence){
+                    ++pos;
+                    continue;
+                }
+
+                std::size_t matchLen = minMatch;
+                std::size_t maxLen = size - lastLiterals - pos;
+                while(matchLen < maxLen && src[ref + matchLen] == src[pos + matchLen]){
+                    ++matchLen;
+                }
+
+                appendSequence(out, src + anchor, pos - anchor, pos - ref, matchLen - minMatch);
+                pos += matchLen;
+                anchor = pos;
+            }
         }
-        m_queueMutex.unlock();
-        return move(entry);
+
+        // remaining literals without match
+        std::size_t litLen = size - anchor;
+        out.push_back((char)((litLen < 15 ? litLen : 15) << 4));
+        appendLength(out, litLen);
+        out.append(src + anchor, litLen);
     }
 
-    int getQueueSize(){
-        int size;
+    // decompresses exactly rawSize bytes into dest; returns false if data is corrupt
+    static bool decompress(const char* src, std::size_t size, char* dest, std::size_t rawSize){
+        std::size_t in = 0;
+        std::size_t out = 0;
 
-        // needed for stability, else it often pauses on exception during runtime (and for a try-catch block I would need a exception transport system between the threads 
-        // with which I don't want to be bothered right now)
-        std::this_thread::sleep_for(std::chrono::nanoseconds(1));
+        while(in < size){
+            std::uint8_t token = (std::uint8_t)src[in++];
 
-        m_queueMutex.lock();
-        size =  m_logEntries.size();
-        m_queueMutex.unlock();
-        
-        return size;
+            std::size_t litLen = token >> 4;
+            if(litLen == 15 && !readLength(src, size, in, litLen)){
+                return false;
+            }
+            if(in + litLen > size || out + litLen > rawSize){
+                return false;
+            }
+            std::memcpy(dest + out, src + in, litLen);
+            in += litLen;
+            out += litLen;
+
+            if(in == size){
+                break;      // last sequence has no match
+            }
+
+            if(in + 2 > size){
+                return false;
+            }
+            std::size_t offset = (std::uint8_t)src[in] | ((std::size_t)(std::uint8_t)src[in + 1] << 8);
+            in += 2;
+            std::size_t matchLen = token & 15;
+            if(matchLen == 15 && !readLength(src, size, in, matchLen)){
+                return false;
+            }
+            matchLen += 4;
+            if(offset == 0 || offset > out || out + matchLen > rawSize){
+                return false;
+            }
+
+            // match may overlap with bytes it produces itself, so copy bytewise
+            for(std::size_t i = 0; i < matchLen; ++i, ++out){
+                dest[out] = dest[out - offset];
+            }
+        }
+        return out == rawSize;
     }
 
-protected:
-    std::mutex m_queueMutex;        // controls queue access
+    // reads frame index of a compressed file: from footer if present, else by walking over frame headers
+    // dataEnd is set to end of last complete frame (where further frames can be appended)
+    static bool readIndex(std::istream& file, std::uint64_t fileSize, std::vector<IndexEntry>& index, std::uint64_t& dataEnd){
+        index.clear();
+        dataEnd = 0;
+
+        Footer footer;
+        if(fileSize >= sizeof(Footer)){
+            file.clear();
+            file.seekg((std::streamoff)(fileSize - sizeof(Footer)));
+            if(file.read((char*)&footer, sizeof(footer)) && footer.magic == s_footerMagic
+               && footer.indexOffset + (std::uint64_t)footer.nFrames * sizeof(IndexEntry) + sizeof(Footer) == fileSize){
+                index.resize(footer.nFrames);
+                file.seekg((std::streamoff)footer.indexOffset);
+                if(footer.nFrames == 0 || file.read((char*)index.data(), footer.nFrames * sizeof(IndexEntry))){
+                    dataEnd = footer.indexOffset;
+                    return true;
+                }
+                index.clear();
+            }
+        }
 
-    std::queue<std::unique_ptr<LogEntry>> m_logEntries;      // if handled by LogThreader, log-method writes into this buffer instead of writing directly to file and/or console
+        // no (valid) footer: walk over frames until end or first incomplete one
+        FrameHeader header;
+        std::uint64_t offset = 0;
+        while(offset + sizeof(FrameHeader) <= fileSize){
+            file.clear();
+            file.seekg((std::streamoff)offset);
+            if(!file.read((char*)&header, sizeof(header)) || header.magic != s_frameMagic){
+                break;
+            }
+            std::uint64_t end = offset + sizeof(FrameHeader) + header.compressedSize;
+            if(end > fileSize){
+                break;
+            }
+            index.push_back({offset, header.firstTimeNs, header.lastTimeNs});
+            offset = end;
+        }
+        dataEnd = offset;
+        file.clear();
+        return false;
+    }
 
 private:
-    // LogThreader needs to access print function
-    friend class LogThreader;
+    static std::uint32_t read32(const char* p){
+        std::uint32_t value;
+        std::memcpy(&value, p, sizeof(value));
+        return value;
+    }
 
-#endif
+    // lengths of 15 and more continue in following bytes (255 each, last one smaller)
+    static void appendLength(std::string& out, std::size_t len){
+        if(len < 15){
+            return;
+        }
+        len -= 15;
+        while(len >= 255){
+            out.push_back((char)255);
+            len -= 255;
+        }
+        out.push_back((char)len);
+    }
+
+    static bool readLength(const char* src, std::size_t size, std::size_t& in, std::size_t& len){
+        std::uint8_t byte;
+        do{
+            if(in >= size){
+                return false;
+            }
+            byte = (std::uint8_t)src[in++];
+            len += byte;
+        } while(byte == 255);
+        return true;
+    }
 
+    static void appendSequence(std::string& out, const char* literals, std::size_t litLen, std::size_t offset, std::size_t matchLen){
+        out.push_back((char)(((litLen < 15 ? litLen : 15) << 4) | (matchLen < 15 ? matchLen : 15)));
+        appendLength(out, litLen);
+        out.append(literals, litLen);
+        out.push_back((char)(offset & 0xFF));
+        out.push_back((char)(offset >> 8));
+        appendLength(out, matchLen);
+    }
 };
 
-// selection from https://www.ibm.com/docs/en/cognos-analytics/10.2.2?topic=SSEP7J_10.2.2/com.ibm.swg.ba.cognos.ug_rtm_wb.10.2.2.doc/c_n30e74.html
-enum LogLevel {
-    Error,
-    Warning,
-    Info,
-    Debug
+// when a log file is due, it gets renamed to <name>.1.<ext> (older ones to .2, .3, ...) and a new file is started
+struct RotationPolicy{
+    std::uint64_t maxSize = 0;                  // bytes per file; 0 -> no size limit
+    std::chrono::seconds interval{0};           // maximal age of a file; 0 -> no time limit
+    std::size_t maxFiles = 5;                   // rotated files kept besides the current one (oldest gets deleted)
+
+    bool isEnabled() const { return maxSize > 0 || interval.count() > 0; }
 };
 
-inline bool logLevelToStr(std::string& str, LogLevel logLevel){
-    switch (logLevel)
+/* Sidecar index of .log and .csv files (<file>.idx), written along with the file so that time ranges can be found
+ * without scanning it (see IndexedLogReader); layout: magic, then one Point every N entries or K bytes
+ * time of a point is the latest time stamp of all entries before it, so times are increasing even if entries
+ * are slightly out of order: all entries in front of a point with time < t are older than t */
+struct LogTimeIndex{
+    static constexpr char s_magic[8] = {'L', 'O', 'G', 'T', 'I', 'D', 'X', '1'};
+
+    struct Point{
+        std::uint64_t offset;       // of first entry after the point in log file
+        std::uint64_t seq;          // number of that entry (counted since index was started)
+        std::int64_t timeNs;        // latest time stamp of entries before (ns since epoch; INT64_MIN if none)
+    };
+
+    static std::string pathOf(const std::string& logPath){
+        return logPath + ".idx";
+    }
+};
+
+/* Writes index points of one log file (used by LogFileSink); a point costs one small write */
+class LogTimeIndexWriter{
+public:
+    LogTimeIndexWriter(){}
+
+    ~LogTimeIndexWriter(){
+        close();
+    }
+
+    LogTimeIndexWriter(const LogTimeIndexWriter&) = delete;
+    LogTimeIndexWriter& operator=(const LogTimeIndexWriter&) = delete;
+
+    // new point after everyEntries entries or everyBytes bytes, whatever comes first (0 -> criterion not used)
+    void setInterval(std::size_t everyEntries, std::size_t everyBytes){
+        m_everyEntries = everyEntries;
+        m_everyBytes = everyBytes;
+    }
+
+    bool isEnabled() const { return m_everyEntries > 0 || m_everyBytes > 0; }
+
+    bool isOpen() const { return m_file != nullptr; }
+
+    // starts index of log file which already holds fileSize bytes; with append, an existing index gets continued
+    bool open(const std::string& logPath, bool append, std::uint64_t fileSize){
+        close();
+        std::string path = LogTimeIndex::pathOf(logPath);
+
+        m_seq = 0;
+        m_maxTimeNs = INT64_MIN;
+        m_isPointDue = true;
+        if(append && fileSize > 0 && resume(path, logPath, fileSize)){
+            m_file = std::fopen(path.c_str(), "ab");
+            return isOpen();
+        }
+
+        m_file = std::fopen(path.c_str(), "wb");
+        if(m_file == nullptr){
+            return false;
+        }
+        std::fwrite(LogTimeIndex::s_magic, 1, sizeof(LogTimeIndex::s_magic), m_file);
+        std::fflush(m_file);
+        return true;
+    }
+
+    void close(){
+        if(m_file != nullptr){
+            std::fclose(m_file);
+            m_file = nullptr;
+        }
+    }
+
+    // called for every entry before it gets written to offset; timeNs 0 -> time of writing
+    void add(std::uint64_t offset, std::int64_t timeNs){
+        if(m_isPointDue || (m_everyEntries > 0 && m_sinceLast >= m_everyEntries) || (m_everyBytes > 0 && offset - m_lastOffset >= m_everyBytes)){
+            LogTimeIndex::Point point{offset, m_seq, m_maxTimeNs};
+            std::fwrite(&point, sizeof(point), 1, m_file);
+            std::fflush(m_file);
+            m_lastOffset = offset;
+            m_sinceLast = 0;
+            m_isPointDue = false;
+        }
+        if(timeNs == 0){
+            timeNs = LogTimeFormatter::nowNs();
+        }
+        m_maxTimeNs = std::max(m_maxTimeNs, timeNs);
+        ++m_seq;
+        ++m_sinceLast;
+    }
+
+private:
+    // continues after last point of existing index; entries written after it are counted by their line breaks
+    bool resume(const std::string& path, const std::string& logPath, std::uint64_t fileSize){
+        std::error_code ec;
+        std::uint64_t indexSize = (std::uint64_t)fs::file_size(path, ec);
+        if(ec || indexSize < sizeof(LogTimeIndex::s_magic) + sizeof(LogTimeIndex::Point)){
+            return false;
+        }
+
+        std::ifstream index(path, std::ios::in | std::ios::binary);
+        char magic[sizeof(LogTimeIndex::s_magic)];
+        LogTimeIndex::Point last;
+        std::uint64_t lastPos = sizeof(magic) + (indexSize - sizeof(magic)) / sizeof(last) * sizeof(last) - sizeof(last);
+        if(!index.read(magic, sizeof(magic)) || std::memcmp(magic, LogTimeIndex::s_magic, sizeof(magic)) != 0
+           || !index.seekg((std::streamoff)lastPos) || !index.read((char*)&last, sizeof(last)) || last.offset > fileSize){
+            return false;
+        }
+        index.close();
+        fs::resize_file(path, lastPos + sizeof(last), ec);     // drops partly written point
+
+        std::ifstream log(logPath, std::ios::in | std::ios::binary);
+        log.seekg((std::streamoff)last.offset);
+        char buffer[4096];
+        std::uint64_t sinceLast = 0;
+        while(log.read(buffer, sizeof(buffer)) || log.gcount() > 0){
+            sinceLast += (std::uint64_t)std::count(buffer, buffer + log.gcount(), '\n');
+        }
+
+        m_seq = last.seq + sinceLast;
+        m_maxTimeNs = last.timeNs;
+        m_lastOffset = last.offset;
+        m_sinceLast = sinceLast;
+        m_isPointDue = false;
+        return true;
+    }
+
+    std::FILE* m_file = nullptr;
+    std::size_t m_everyEntries = 0;
+    std::size_t m_everyBytes = 0;
+
+    std::uint64_t m_seq = 0;                    // number of next entry
+    std::int64_t m_maxTimeNs = INT64_MIN;       // latest time stamp so far
+    std::uint64_t m_lastOffset = 0;             // of last point
+    std::size_t m_sinceLast = 0;                // entries since last point
+    bool m_isPointDue = true;                   // first entry after open gets a point
+};
+
+#ifdef __linux__
+/* Executes writes and fdatasync calls of one file asynchronously (see LogAsyncFile); used by one thread at a time */
+class LogAsyncBackend{
+public:
+    struct Completion{
+        std::uint64_t tag;          // as given to submitWrite or submitBarrier
+        std::int64_t result;        // bytes written or -errno
+    };
+
+    static constexpr std::uint64_t s_barrierTag = 1ull << 63;      // tags from here on belong to barriers
+
+    virtual ~LogAsyncBackend(){}
+
+    // writes len bytes of buffer tag (index of buffer given to constructor) at offset; false if it couldn't be queued
+    virtual bool submitWrite(std::uint64_t tag, const char* data, std::size_t len, std::uint64_t offset) = 0;
+
+    // completes once all writes submitted before have completed (sync: followed by fdatasync); tag >= s_barrierTag
+    virtual bool submitBarrier(std::uint64_t tag, bool sync) = 0;
+
+    // takes next completion; wait -> blocks until there is one
+    virtual bool poll(Completion& completion, bool wait) = 0;
+
+    // blocks until everything submitted has completed (completions still have to be polled)
+    // no locks and no allocation, so that it can be used from within a signal handler
+    virtual void waitIdle() = 0;
+
+    virtual const char* name() const = 0;
+};
+
+#if LOGGER_HAS_IO_URING
+/* io_uring with the raw system calls (no liburing needed): one ring per file, write buffers registered once,
+ * so that the kernel doesn't have to map them for every write; submission and completion need no locks */
+class LogUring : public LogAsyncBackend{
+public:
+    LogUring(int fd, std::size_t entries, const std::vector<struct iovec>& buffers)
+        :m_fd(fd)
     {
-    case LogLevel::Error:
-        str = "ERROR";
+        struct io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+        m_ringFd = (int)syscall(__NR_io_uring_setup, (unsigned)entries, &params);
+        if(m_ringFd < 0){
+            return;
+        }
+        if(!supportsOps()){
+            release();      // pwrite pool is used instead
+            return;
+        }
+
+        m_sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        m_cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+        bool singleMmap = params.features & IORING_FEAT_SINGLE_MMAP;
+        if(singleMmap){
+            m_sqRingSize = m_cqRingSize = std::max(m_sqRingSize, m_cqRingSize);
+        }
+
+        m_sqRing = mapRing(m_sqRingSize, IORING_OFF_SQ_RING);
+        m_cqRing = singleMmap ? m_sqRing : mapRing(m_cqRingSize, IORING_OFF_CQ_RING);
+        m_sqes = (struct io_uring_sqe*)mapRing(params.sq_entries * sizeof(struct io_uring_sqe), IORING_OFF_SQES);
+        m_sqesSize = params.sq_entries * sizeof(struct io_uring_sqe);
+        if(m_sqRing == nullptr || m_cqRing == nullptr || m_sqes == nullptr){
+            release();
+            return;
+        }
+
+        m_sqTail = (unsigned*)(m_sqRing + params.sq_off.tail);
+        m_sqMask = *(unsigned*)(m_sqRing + params.sq_off.ring_mask);
+        m_sqArray = (unsigned*)(m_sqRing + params.sq_off.array);
+        m_cqHead = (unsigned*)(m_cqRing + params.cq_off.head);
+        m_cqTail = (unsigned*)(m_cqRing + params.cq_off.tail);
+        m_cqMask = *(unsigned*)(m_cqRing + params.cq_off.ring_mask);
+        m_cqes = (struct io_uring_cqe*)(m_cqRing + params.cq_off.cqes);
+
+        // fixed buffers count against RLIMIT_MEMLOCK on older kernels; plain writes work without
+        m_isFixed = !buffers.empty()
+                    && syscall(__NR_io_uring_register, m_ringFd, IORING_REGISTER_BUFFERS, buffers.data(), (unsigned)buffers.size()) == 0;
+    }
+
+    ~LogUring(){
+        release();
+    }
+
+    LogUring(const LogUring&) = delete;
+    LogUring& operator=(const LogUring&) = delete;
+
+    bool isOpen() const { return m_ringFd >= 0; }
+
+    bool submitWrite(std::uint64_t tag, const char* data, std::size_t len, std::uint64_t offset) override{
+        struct io_uring_sqe* sqe = nextSqe();
+        sqe->opcode = m_isFixed ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE;
+        sqe->fd = m_fd;
+        sqe->addr = (std::uint64_t)(std::uintptr_t)data;
+        sqe->len = (std::uint32_t)len;
+        sqe->off = offset;
+        sqe->buf_index = m_isFixed ? (std::uint16_t)tag : 0;
+        sqe->user_data = tag;
+        return submit();
+    }
+
+    bool submitBarrier(std::uint64_t tag, bool sync) override{
+        struct io_uring_sqe* sqe = nextSqe();
+        sqe->opcode = sync ? IORING_OP_FSYNC : IORING_OP_NOP;
+        sqe->flags = IOSQE_IO_DRAIN;        // starts after everything submitted before has completed
+        sqe->fd = sync ? m_fd : -1;
+        sqe->fsync_flags = sync ? IORING_FSYNC_DATASYNC : 0;
+        sqe->user_data = tag;
+        return submit();
+    }
+
+    bool poll(Completion& completion, bool wait) override{
+        unsigned head = *m_cqHead;     // only written by this thread
+        while(head == std::atomic_ref<unsigned>(*m_cqTail).load(std::memory_order_acquire)){
+            if(!wait || m_inFlight == 0){
+                return false;
+            }
+            enter(0, 1, IORING_ENTER_GETEVENTS);
+        }
+
+        const struct io_uring_cqe& cqe = m_cqes[head & m_cqMask];
+        completion.tag = cqe.user_data;
+        completion.result = cqe.res;
+        std::atomic_ref<unsigned>(*m_cqHead).store(head + 1, std::memory_order_release);
+        --m_inFlight;
         return true;
-    case LogLevel::Warning:
-        str = "WARNING";
+    }
+
+    void waitIdle() override{
+        while(m_inFlight > 0){
+            unsigned ready = std::atomic_ref<unsigned>(*m_cqTail).load(std::memory_order_acquire) - *m_cqHead;
+            if(ready >= m_inFlight){
+                return;
+            }
+            enter(0, (unsigned)m_inFlight - ready, IORING_ENTER_GETEVENTS);
+        }
+    }
+
+    const char* name() const override{ return m_isFixed ? "io_uring (fixed buffers)" : "io_uring"; }
+
+private:
+    // kernels before 5.6 have io_uring, but no IORING_OP_WRITE (every write would fail with -EINVAL) and no probing
+    bool supportsOps(){
+        const unsigned nOps = 256;
+        std::vector<char> buffer(sizeof(struct io_uring_probe) + nOps * sizeof(struct io_uring_probe_op), 0);
+        struct io_uring_probe* probe = (struct io_uring_probe*)buffer.data();
+        if(syscall(__NR_io_uring_register, m_ringFd, IORING_REGISTER_PROBE, probe, nOps) != 0){
+            return false;
+        }
+        for(unsigned op : {IORING_OP_WRITE, IORING_OP_WRITE_FIXED, IORING_OP_FSYNC, IORING_OP_NOP}){
+            if(op >= probe->ops_len || !(probe->ops[op].flags & IO_URING_OP_SUPPORTED)){
+                return false;
+            }
+        }
         return true;
-    case LogLevel::Info:
-        str = "INFO";
+    }
+
+    char* mapRing(std::size_t size, off_t offset){
+        void* ring = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_ringFd, offset);
+        return ring == MAP_FAILED ? nullptr : (char*)ring;
+    }
+
+    // submission queue can't be full: requests are submitted one by one and at most entries are in flight
+    struct io_uring_sqe* nextSqe(){
+        unsigned index = *m_sqTail & m_sqMask;
+        struct io_uring_sqe* sqe = &m_sqes[index];
+        std::memset(sqe, 0, sizeof(*sqe));
+        m_sqArray[index] = index;
+        return sqe;
+    }
+
+    bool submit(){
+        std::atomic_ref<unsigned>(*m_sqTail).store(*m_sqTail + 1, std::memory_order_release);
+        ++m_inFlight;
+        while(enter(1, 0, 0) < 0){
+            if(errno != EINTR && errno != EAGAIN){
+                // kernel has not taken the request; take it back
+                std::atomic_ref<unsigned>(*m_sqTail).store(*m_sqTail - 1, std::memory_order_release);
+                --m_inFlight;
+                return false;
+            }
+        }
         return true;
-    case LogLevel::Debug:
-        str = "DEBUG";
+    }
+
+    int enter(unsigned toSubmit, unsigned minComplete, unsigned flags){
+        return (int)syscall(__NR_io_uring_enter, m_ringFd, toSubmit, minComplete, flags, nullptr, 0);
+    }
+
+    void release(){
+        if(m_sqes != nullptr) munmap(m_sqes, m_sqesSize);
+        if(m_cqRing != nullptr && m_cqRing != m_sqRing) munmap(m_cqRing, m_cqRingSize);
+        if(m_sqRing != nullptr) munmap(m_sqRing, m_sqRingSize);
+        if(m_ringFd >= 0) ::close(m_ringFd);
+        m_sqes = nullptr;
+        m_cqRing = m_sqRing = nullptr;
+        m_ringFd = -1;
+    }
+
+    int m_fd;
+    int m_ringFd = -1;
+    bool m_isFixed = false;
+    std::size_t m_inFlight = 0;
+
+    char* m_sqRing = nullptr;
+    char* m_cqRing = nullptr;
+    std::size_t m_sqRingSize = 0;
+    std::size_t m_cqRingSize = 0;
+    struct io_uring_sqe* m_sqes = nullptr;
+    std::size_t m_sqesSize = 0;
+
+    unsigned* m_sqTail = nullptr;
+    unsigned m_sqMask = 0;
+    unsigned* m_sqArray = nullptr;
+    unsigned* m_cqHead = nullptr;
+    unsigned* m_cqTail = nullptr;
+    unsigned m_cqMask = 0;
+    struct io_uring_cqe* m_cqes = nullptr;
+};
+#endif // LOGGER_HAS_IO_URING
+
+#if ENABLE_MULTITHREADING
+/* Threads executing pwrite and fdatasync for all files without io_uring (see LogPoolBackend)
+ * jobs are taken in order, so a sync job only waits for writes which are already being executed */
+class LogIoPool{
+public:
+    // results of one file, filled by pool threads and taken by the thread writing the file
+    struct Completions{
+        std::mutex mutex;
+        std::condition_variable cv;
+        std::vector<LogAsyncBackend::Completion> done;
+        std::uint64_t writesDone = 0;
+        std::atomic<std::uint64_t> completed{0};    // jobs put into done so far
+    };
+
+    struct Job{
+        Completions* owner;
+        int fd;
+        std::uint64_t tag;
+        const char* data;
+        std::size_t len;
+        std::uint64_t offset;
+        std::uint64_t writesBefore;     // barriers: writes of file submitted before
+        bool sync;                      // barriers: fdatasync afterwards
+    };
+
+    static constexpr std::size_t s_nThreads = 2;
+
+    // started on first use
+    static LogIoPool& instance(){
+        static LogIoPool pool;
+        return pool;
+    }
+
+    ~LogIoPool(){
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_running = false;
+        }
+        m_cv.notify_all();
+        for(std::thread& thread : m_threads){
+            thread.join();
+        }
+    }
+
+    LogIoPool(const LogIoPool&) = delete;
+    LogIoPool& operator=(const LogIoPool&) = delete;
+
+    // executed right away if pool has already been shut down (files closed during static destruction)
+    void submit(const Job& job){
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if(m_running){
+                m_jobs.push_back(job);
+                m_cv.notify_one();
+                return;
+            }
+        }
+        execute(job);
+    }
+
+private:
+    LogIoPool(){
+        for(std::size_t i = 0; i < s_nThreads; ++i){
+            m_threads.emplace_back(&LogIoPool::working, this);
+        }
+    }
+
+    void working(){
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while(true){
+            m_cv.wait(lock, [this]{ return !m_jobs.empty() || !m_running; });
+            if(m_jobs.empty()){
+                break;
+            }
+            Job job = m_jobs.front();
+            m_jobs.pop_front();
+            lock.unlock();
+            execute(job);
+            lock.lock();
+        }
+    }
+
+    static void execute(const Job& job){
+        std::int64_t result = job.tag >= LogAsyncBackend::s_barrierTag ? barrier(job) : write(job);
+        {
+            std::lock_guard<std::mutex> ownerLock(job.owner->mutex);
+            job.owner->done.push_back({job.tag, result});
+            if(job.tag < LogAsyncBackend::s_barrierTag){
+                ++job.owner->writesDone;
+            }
+            job.owner->completed.fetch_add(1, std::memory_order_release);
+        }
+        job.owner->cv.notify_all();
+    }
+
+    static std::int64_t write(const Job& job){
+        std::size_t written = 0;
+        while(written < job.len){
+            ssize_t n = ::pwrite(job.fd, job.data + written, job.len - written, (off_t)(job.offset + written));
+            if(n < 0){
+                if(errno == EINTR) continue;
+                return -errno;
+            }
+            written += (std::size_t)n;
+        }
+        return (std::int64_t)written;
+    }
+
+    static std::int64_t barrier(const Job& job){
+        {
+            std::unique_lock<std::mutex> ownerLock(job.owner->mutex);
+            job.owner->cv.wait(ownerLock, [&]{ return job.owner->writesDone >= job.writesBefore; });
+        }
+        if(!job.sync){
+            return 0;
+        }
+        return ::fdatasync(job.fd) == 0 ? 0 : -errno;
+    }
+
+    std::vector<std::thread> m_threads;
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::deque<Job> m_jobs;
+    bool m_running = true;
+};
+
+/* Fallback if io_uring is not available: jobs are executed by LogIoPool with pwrite */
+class LogPoolBackend : public LogAsyncBackend{
+public:
+    LogPoolBackend(int fd)
+        :m_fd(fd)
+    {}
+
+    ~LogPoolBackend(){
+        waitIdle();
+    }
+
+    bool submitWrite(std::uint64_t tag, const char* data, std::size_t len, std::uint64_t offset) override{
+        ++m_writesSubmitted;
+        ++m_submitted;
+        LogIoPool::instance().submit({&m_completions, m_fd, tag, data, len, offset, 0, false});
         return true;
     }
 
-    str = "UNDEFINED";
-    return false;
-}
+    bool submitBarrier(std::uint64_t tag, bool sync) override{
+        ++m_submitted;
+        LogIoPool::instance().submit({&m_completions, m_fd, tag, nullptr, 0, 0, m_writesSubmitted, sync});
+        return true;
+    }
+
+    bool poll(Completion& completion, bool wait) override{
+        if(m_taken == m_ready.size()){
+            // nothing new has completed: no need to lock
+            if(!wait && m_completions.completed.load(std::memory_order_acquire) == m_received){
+                return false;
+            }
+            m_ready.clear();
+            m_taken = 0;
+            std::unique_lock<std::mutex> lock(m_completions.mutex);
+            if(wait){
+                m_completions.cv.wait(lock, [this]{ return !m_completions.done.empty() || m_received == m_submitted; });
+            }
+            m_ready.swap(m_completions.done);
+            m_received += m_ready.size();
+        }
+        if(m_taken == m_ready.size()){
+            return false;
+        }
+        completion = m_ready[m_taken++];
+        return true;
+    }
+
+    // pool threads keep working while the thread waiting here is in a signal handler
+    void waitIdle() override{
+        for(int i = 0; i < 100000 && m_completions.completed.load(std::memory_order_acquire) < m_submitted; ++i){
+            struct timespec pause = {0, 10000};
+            nanosleep(&pause, nullptr);
+        }
+    }
+
+    const char* name() const override{ return "pwrite pool"; }
+
+private:
+    int m_fd;
+    LogIoPool::Completions m_completions;
+    std::uint64_t m_writesSubmitted = 0;
+    std::uint64_t m_submitted = 0;              // writes and syncs
+    std::uint64_t m_received = 0;               // completions taken from m_completions
+    std::vector<Completion> m_ready;            // taken from m_completions, handed out one by one
+    std::size_t m_taken = 0;
+};
+#endif // ENABLE_MULTITHREADING
+
+/* Asynchronous output of LogFileSink (see Logger::enableAsyncIo)
+ * data is copied into one of depth buffers and written at its offset by io_uring (or LogIoPool) while the
+ * writing thread continues; it only waits if all buffers are in flight. Offsets are assigned when data is
+ * handed over, so the file has the same content as with write calls, even if writes complete out of order.
+ * While writes are in flight, further data is collected in the open buffer and submitted once they have
+ * completed (or by the next service() call), so small unbuffered entries get batched by themselves.
+ * Barriers (flush/sync requests, periodic fdatasync) are submitted one at a time; requests arriving meanwhile
+ * share the next one (group commit) */
+class LogAsyncFile{
+public:
+    LogAsyncFile(const AsyncIoPolicy& policy)
+        :m_policy(policy)
+    {
+        m_policy.depth = std::max<std::size_t>(m_policy.depth, 1);
+        m_policy.bufferSize = std::max<std::size_t>(m_policy.bufferSize, 4096);
+        m_memory.reset(new char[m_policy.depth * m_policy.bufferSize]);
+        m_slots.resize(m_policy.depth);
+    }
+
+    ~LogAsyncFile(){
+        close();
+    }
+
+    LogAsyncFile(const LogAsyncFile&) = delete;
+    LogAsyncFile& operator=(const LogAsyncFile&) = delete;
+
+    // starts writing to fd at offset (fd must not be opened with O_APPEND); false if no backend is available
+    bool open(int fd, std::uint64_t offset){
+        close();
+        m_fd = fd;
+        m_offset = offset;
+        m_free.clear();
+        for(std::size_t i = m_policy.depth; i > 0; --i){
+            m_free.push_back(i - 1);
+        }
+
+        #if LOGGER_HAS_IO_URING
+        if(m_policy.useUring){
+            std::vector<struct iovec> buffers(m_policy.depth);
+            for(std::size_t i = 0; i < m_policy.depth; ++i){
+                buffers[i].iov_base = slotData(i);
+                buffers[i].iov_len = m_policy.bufferSize;
+            }
+            std::unique_ptr<LogUring> uring = std::make_unique<LogUring>(fd, m_policy.depth + 1, buffers);
+            if(uring->isOpen()){
+                m_backend = std::move(uring);
+            }
+        }
+        #endif
+        #if ENABLE_MULTITHREADING
+        if(!m_backend){
+            m_backend = std::make_unique<LogPoolBackend>(fd);
+        }
+        #endif
+
+        m_lastSync = std::chrono::steady_clock::now();
+        return isOpen();
+    }
+
+    bool isOpen() const { return m_backend != nullptr; }
+
+    // waits for everything in flight (synced if policy says so); fd is left open
+    void close(){
+        if(!isOpen()){
+            return;
+        }
+        submitOpen();
+        if(m_policy.syncInterval.count() > 0 && m_isUnsynced){
+            m_isWaiting = m_isSyncWaiting = true;
+        }
+        settle();
+        while(m_inFlight > 0){
+            reap(true);
+        }
+        m_backend.reset();
+    }
+
+    // hands data over to backend (in as many buffers as needed); waits only if no buffer is free
+    void write(const char* first, std::size_t firstLen, const char* second, std::size_t secondLen, bool newline){
+        reap(false);
+        syncIfDue();
+
+        static const char newlineChar = '\n';
+        std::string_view parts[3] = {{first, firstLen}, {second, secondLen}, {&newlineChar, newline ? 1u : 0u}};
+        for(std::string_view part : parts){
+            while(!part.empty()){
+                if(m_open == s_noSlot){
+                    m_open = acquire();
+                }
+                Slot& slot = m_slots[m_open];
+                std::size_t n = std::min(part.size(), m_policy.bufferSize - slot.len);
+                std::memcpy(slotData(m_open) + slot.len, part.data(), n);
+                slot.len += n;
+                m_offset += n;
+                part.remove_prefix(n);
+                if(slot.len == m_policy.bufferSize){
+                    submitOpen();
+                }
+            }
+        }
+
+        // disk is idle: no reason to wait for more
+        if(m_writesInFlight == 0){
+            submitOpen();
+        }
+    }
+
+    // process is going down: waits for writes in flight, then writes data with plain pwrite calls
+    // (no locks, no allocation; see LogCrashHandler)
+    void writeEmergency(const char* first, std::size_t firstLen, const char* second, std::size_t secondLen, bool newline){
+        m_backend->waitIdle();
+        if(m_open != s_noSlot){
+            Slot& slot = m_slots[m_open];
+            writeAt(slotData(m_open), slot.len, slot.offset);
+            m_open = s_noSlot;
+        }
+
+        static const char newlineChar = '\n';
+        std::string_view parts[3] = {{first, firstLen}, {second, secondLen}, {&newlineChar, newline ? 1u : 0u}};
+        for(std::string_view part : parts){
+            writeAt(part.data(), part.size(), m_offset);
+            m_offset += part.size();
+        }
+    }
+
+    // callbacks get called once everything handed over so far has been written (sync: and fdatasync has completed)
+    // with the outcome; they are called by the thread using the file (from write, service, settle or close)
+    void addBarrier(bool sync, std::vector<LogDurabilityCallback>&& callbacks){
+        submitOpen();
+        for(LogDurabilityCallback& callback : callbacks){
+            m_waiting.push_back(std::move(callback));
+        }
+        m_isWaiting = true;
+        m_isSyncWaiting = m_isSyncWaiting || sync;
+        if(m_barriers.empty()){
+            submitBarrier();
+        }
+    }
+
+    bool hasPendingBarriers() const { return m_isWaiting || !m_barriers.empty(); }
+
+    // waits until all barriers have completed
+    void settle(){
+        while(hasPendingBarriers()){
+            if(m_barriers.empty()){
+                submitBarrier();
+                continue;
+            }
+            reap(true);
+        }
+    }
+
+    // takes completions, submits collected data and starts fdatasync if due (called periodically by LogThreader)
+    void service(){
+        reap(false);
+        submitOpen();
+        syncIfDue();
+    }
+
+    const char* backendName() const { return isOpen() ? m_backend->name() : ""; }
+
+    // may be called from any thread (counters are only written by the thread using the file)
+    std::uint64_t bytes() const { return m_stats.bytes.load(std::memory_order_relaxed); }
+    std::uint64_t syscalls() const { return m_stats.syscalls.load(std::memory_order_relaxed); }
+    std::uint64_t syncs() const { return m_stats.syncs.load(std::memory_order_relaxed); }
+    std::uint64_t stalls() const { return m_stats.stalls.load(std::memory_order_relaxed); }
+    std::uint64_t errors() const { return m_stats.errors.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr std::size_t s_noSlot = SIZE_MAX;
+
+    struct Slot{
+        std::size_t len = 0;
+        std::size_t done = 0;           // already written (after short writes)
+        std::uint64_t offset = 0;
+    };
+
+    char* slotData(std::size_t slot){ return m_memory.get() + slot * m_policy.bufferSize; }
+
+    // free buffer, data put into it goes to m_offset
+    std::size_t acquire(){
+        if(m_free.empty()){
+            count(m_stats.stalls);
+            while(m_free.empty()){
+                reap(true);
+            }
+        }
+        std::size_t slot = m_free.back();
+        m_free.pop_back();
+        m_slots[slot] = Slot();
+        m_slots[slot].offset = m_offset;
+        return slot;
+    }
+
+    void submitOpen(){
+        if(m_open == s_noSlot){
+            return;
+        }
+        m_isUnsynced = true;
+        submit(m_open);
+        m_open = s_noSlot;
+    }
+
+    void submit(std::size_t slot){
+        Slot& s = m_slots[slot];
+        count(m_stats.syscalls);
+        if(m_backend->submitWrite(slot, slotData(slot) + s.done, s.len - s.done, s.offset + s.done)){
+            ++m_inFlight;
+            ++m_writesInFlight;
+            return;
+        }
+
+        // backend refused request: write it here
+        writeAt(slotData(slot) + s.done, s.len - s.done, s.offset + s.done);
+        m_free.push_back(slot);
+    }
+
+    void writeAt(const char* data, std::size_t len, std::uint64_t offset){
+        while(len > 0){
+            ssize_t n = ::pwrite(m_fd, data, len, (off_t)offset);
+            count(m_stats.syscalls);
+            if(n < 0){
+                if(errno == EINTR) continue;
+                count(m_stats.errors);
+                return;
+            }
+            data += n;
+            len -= (std::size_t)n;
+            offset += (std::uint64_t)n;
+            count(m_stats.bytes, (std::uint64_t)n);
+        }
+    }
+
+    void syncIfDue(){
+        if(m_policy.syncInterval.count() > 0 && m_isUnsynced && std::chrono::steady_clock::now() - m_lastSync >= m_policy.syncInterval){
+            m_isWaiting = m_isSyncWaiting = true;
+            if(m_barriers.empty()){
+                submitBarrier();
+            }
+        }
+    }
+
+    // everything waiting goes into one barrier
+    void submitBarrier(){
+        Barrier barrier{LogAsyncBackend::s_barrierTag + m_nextBarrier++, m_isSyncWaiting, std::move(m_waiting)};
+        m_waiting.clear();
+        m_isWaiting = m_isSyncWaiting = false;
+        if(barrier.sync){
+            m_isUnsynced = false;
+            m_lastSync = std::chrono::steady_clock::now();
+        }
+
+        if(m_backend->submitBarrier(barrier.tag, barrier.sync)){
+            ++m_inFlight;
+            m_barriers.push_back(std::move(barrier));
+            return;
+        }
+
+        // backend refused request: wait for writes in flight and do it here
+        while(m_writesInFlight > 0){
+            reap(true);
+        }
+        std::int64_t result = barrier.sync && ::fdatasync(m_fd) != 0 ? -errno : 0;
+        m_barriers.push_back(std::move(barrier));
+        completeBarrier(result);
+    }
+
+    void completeBarrier(std::int64_t result){
+        Barrier barrier = std::move(m_barriers.front());
+        m_barriers.pop_front();
+        if(barrier.sync){
+            count(m_stats.syncs);
+        }
+        if(result < 0){
+            count(m_stats.errors);
+        }
+
+        // failed writes since last barrier make it fail as well
+        std::uint64_t errors = m_stats.errors.load(std::memory_order_relaxed);
+        bool isOk = errors == m_errorsSeen;
+        m_errorsSeen = errors;
+        for(LogDurabilityCallback& callback : barrier.callbacks){
+            callback(isOk);
+        }
+    }
+
+    // handles completions; wait -> at least one (if anything is in flight)
+    void reap(bool wait){
+        LogAsyncBackend::Completion completion;
+        while(m_inFlight > 0 && m_backend->poll(completion, wait)){
+            wait = false;
+            --m_inFlight;
+            if(completion.tag >= LogAsyncBackend::s_barrierTag){
+                completeBarrier(completion.result);
+                if(m_isWaiting){
+                    submitBarrier();
+                }
+                continue;
+            }
+
+            --m_writesInFlight;
+            std::size_t slot = (std::size_t)completion.tag;
+            Slot& s = m_slots[slot];
+            if(completion.result == -EINTR || completion.result == -EAGAIN){
+                submit(slot);
+                continue;
+            }
+            if(completion.result <= 0){
+                count(m_stats.errors);      // nothing sensible left to do, data is lost
+                m_free.push_back(slot);
+                continue;
+            }
+            count(m_stats.bytes, (std::uint64_t)completion.result);
+            s.done += (std::size_t)completion.result;
+            if(s.done < s.len){
+                submit(slot);       // short write: rest at its offset
+            }
+            else{
+                m_free.push_back(slot);
+            }
+        }
+    }
+
+    static void count(std::atomic<std::uint64_t>& counter, std::uint64_t n=1){
+        counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+
+    AsyncIoPolicy m_policy;
+    std::unique_ptr<LogAsyncBackend> m_backend;
+    int m_fd = -1;
+    std::uint64_t m_offset = 0;             // where next data goes (behind data of open buffer)
+
+    std::unique_ptr<char[]> m_memory;       // depth buffers of bufferSize bytes
+    std::vector<Slot> m_slots;
+    std::vector<std::size_t> m_free;
+    std::size_t m_open = s_noSlot;          // buffer being filled
+    std::size_t m_inFlight = 0;             // writes and syncs
+    std::size_t m_writesInFlight = 0;
+
+    bool m_isUnsynced = false;
+    std::chrono::steady_clock::time_point m_lastSync;
+
+    struct Barrier{
+        std::uint64_t tag;
+        bool sync;
+        std::vector<LogDurabilityCallback> callbacks;
+    };
+    std::deque<Barrier> m_barriers;                     // in flight, completed in order
+    std::vector<LogDurabilityCallback> m_waiting;       // for next barrier
+    bool m_isWaiting = false;                           // next barrier is needed (also without callbacks)
+    bool m_isSyncWaiting = false;                       // next barrier has to sync
+    std::uint64_t m_nextBarrier = 0;
+    std::uint64_t m_errorsSeen = 0;                     // errors when last barrier completed
+
+    struct Counters{
+        std::atomic<std::uint64_t> bytes{0};
+        std::atomic<std::uint64_t> syscalls{0};
+        std::atomic<std::uint64_t> syncs{0};
+        std::atomic<std::uint64_t> stalls{0};
+        std::atomic<std::uint64_t> errors{0};
+    };
+    Counters m_stats;
+};
+#endif // __linux__
+
+class Logger;
+
+/* Loggers which get drained by LogCrashHandler when the process dies
+ * fixed amount of slots, so that it can be walked from a signal handler without locks */
+struct LogCrashRegistry{
+    static constexpr std::size_t s_capacity = 256;
+
+    // every logger registers itself (loggers beyond capacity are not drained on crash)
+    static void add(Logger* logger){
+        for(std::atomic<Logger*>& slot : s_loggers){
+            Logger* expected = nullptr;
+            if(slot.compare_exchange_strong(expected, logger, std::memory_order_acq_rel)){
+                return;
+            }
+        }
+    }
+
+    static void remove(Logger* logger){
+        for(std::atomic<Logger*>& slot : s_loggers){
+            Logger* expected = logger;
+            if(slot.compare_exchange_strong(expected, nullptr, std::memory_order_acq_rel)){
+                return;
+            }
+        }
+    }
+
+    // set once the process is going down; sinks then write every entry right away (see LogFileSink::append)
+    static bool isCrashing(){ return s_isCrashing.load(std::memory_order_relaxed); }
+
+    inline static std::atomic<Logger*> s_loggers[s_capacity];
+    inline static std::atomic<bool> s_isCrashing{false};
+};
+
+/* Write-combining file output: collects entries in a buffer and writes them with few large (vectored) writes */
+class LogFileSink{
+public:
+    LogFileSink(){}
+
+    ~LogFileSink(){
+        close();
+    }
+
+    LogFileSink(const LogFileSink&) = delete;
+    LogFileSink& operator=(const LogFileSink&) = delete;
+
+    // opens file; append=false deletes previous content
+    bool open(const std::string& path, bool append){
+        close();
+
+        // compressed file: continue after last complete frame (index and footer get written anew on close)
+        m_index.clear();
+        std::uint64_t compressedEnd = 0;
+        if(m_compressBlockSize > 0 && append){
+            std::error_code ec;
+            std::uint64_t fileSize = (std::uint64_t)fs::file_size(path, ec);
+            if(!ec && fileSize > 0){
+                std::ifstream file(path, std::ios::in | std::ios::binary);
+                LogCompression::readIndex(file, fileSize, m_index, compressedEnd);
+                file.close();
+                fs::resize_file(path, compressedEnd, ec);
+            }
+        }
+
+        #ifdef __linux__
+        int flags = O_WRONLY | O_CREAT | O_CLOEXEC | (append ? O_APPEND : O_TRUNC);
+        m_fd = ::open(path.c_str(), flags, 0644);
+        #else
+        m_file.open(path, append ? (std::ios::out | std::ios::app | std::ios::binary) : (std::ios::out | std::ios::binary));
+        #endif
+
+        m_path = path;
+        m_isAppending = append;
+        std::error_code ec;
+        m_fileSize = append ? (std::uint64_t)fs::file_size(path, ec) : 0;
+        if(ec){
+            m_fileSize = 0;
+        }
+        m_fileOffset = m_fileSize;
+        m_openTime = std::chrono::steady_clock::now();
+
+        #ifdef __linux__
+        if(m_async && isOpen() && !attachAsync()){
+            m_async.reset();
+        }
+        #endif
+
+        if(m_timeIndex.isEnabled() && m_compressBlockSize == 0 && isOpen()){
+            m_timeIndex.open(path, append, m_fileSize);
+        }
+
+        return isOpen();
+    }
+
+    bool isOpen() const {
+        #ifdef __linux__
+        return m_fd >= 0;
+        #else
+        return m_file.is_open();
+        #endif
+    }
+
+    void close(){
+        if(!isOpen()){
+            return;
+        }
+        commit();
+        flush();
+
+        if(m_compressBlockSize > 0){
+            writeIndex();
+        }
+        m_timeIndex.close();
+
+        #ifdef __linux__
+        if(m_async){
+            m_async->close();
+        }
+        ::close(m_fd);
+        m_fd = -1;
+        #else
+        m_file.close();
+        #endif
+    }
+
+    // writes msg followed by newline according to flush policy
+    // timeNs: time stamp of entry for time index (0 -> time of writing)
+    void write(std::string_view msg, LogLevel logLevel=LogLevel::Info, std::int64_t timeNs=0){
+        append(msg, true, logLevel, timeNs);
+        if((int)logLevel <= m_policy.syncLevel){
+            requestSync();
+        }
+    }
+
+    // writes msg as it is (no newline added) according to flush policy; not an entry of time index
+    void writeRaw(std::string_view msg, LogLevel logLevel=LogLevel::Info){
+        append(msg, false, logLevel);
+        if((int)logLevel <= m_policy.syncLevel){
+            requestSync();
+        }
+    }
+
+    // done gets called once everything written so far has reached the OS (sync: and fdatasync has completed)
+    // requests are collected until commit(), so that all requests of a batch share one fdatasync
+    void addDurabilityRequest(bool sync, LogDurabilityCallback done){
+        m_durabilityRequests.push_back(std::move(done));
+        m_isSyncDue = m_isSyncDue || sync;
+    }
+
+    // satisfies collected requests (called by whoever writes the entries: after every batch for threaded loggers)
+    // asynchronous output: callbacks are called once the writes have completed (see LogAsyncFile::addBarrier)
+    void commit(){
+        if(m_durabilityRequests.empty() && !m_isSyncDue){
+            return;
+        }
+        std::vector<LogDurabilityCallback> requests;
+        requests.swap(m_durabilityRequests);
+        bool sync = m_isSyncDue;
+        m_isSyncDue = false;
+
+        if(!isOpen() || LogCrashRegistry::isCrashing()){
+            for(LogDurabilityCallback& request : requests){
+                request(false);
+            }
+            return;
+        }
+        flush();
+
+        #ifdef __linux__
+        if(m_async && m_async->isOpen()){
+            m_async->addBarrier(sync, std::move(requests));
+            return;
+        }
+        bool isOk = !sync || ::fdatasync(m_fd) == 0;
+        #else
+        m_file.flush();
+        bool isOk = m_file.good();  // no fdatasync for std::ofstream
+        #endif
+        if(sync){
+            count(m_stats.syncs);
+        }
+        isOk = isOk && !m_hasWriteFailed;
+        m_hasWriteFailed = false;
+        for(LogDurabilityCallback& request : requests){
+            request(isOk);
+        }
+    }
+
+    // waits until all committed requests have been satisfied (only asynchronous output has to wait)
+    void settle(){
+        #ifdef __linux__
+        if(m_async && m_async->isOpen()){
+            m_async->settle();
+        }
+        #endif
+    }
+
+    // asynchronous output: committed requests are still in flight (LogThreader polls more often then)
+    bool hasPendingCommits() const {
+        #ifdef __linux__
+        return m_async && m_async->isOpen() && m_async->hasPendingBarriers();
+        #else
+        return false;
+        #endif
+    }
+
+    // syncs of entries with syncLevel are only committed by LogThreader after each batch (else after each entry)
+    void setGroupCommit(bool enable){
+        m_isGroupCommit = enable;
+    }
+
+    // hands all buffered data to the OS (compressed: as one frame)
+    void flush(){
+        if(m_buffer.empty()){
+            return;
+        }
+        if(m_compressBlockSize > 0){
+            writeFrame();
+        }
+        else{
+            writeOut(m_buffer.data(), m_buffer.size(), nullptr, 0);
+        }
+        m_buffer.clear();
+    }
+
+    // writes buffered data with plain write calls only (no allocation; compressed files get an uncompressed frame)
+    // used by LogCrashHandler, so that data can be saved from within a signal handler
+    void emergencyFlush(){
+        if(!isOpen() || m_buffer.empty()){
+            return;
+        }
+        writeEmergency(m_buffer.data(), m_buffer.size(), false);
+        m_buffer.clear();
+    }
+
+    // flushes if oldest buffered entry is older than maxDelay (called periodically by LogThreader)
+    void flushIfDue(){
+        #ifdef __linux__
+        if(m_async){
+            m_async->service();
+        }
+        #endif
+        if(!m_buffer.empty() && std::chrono::steady_clock::now() - m_firstBufferedTime >= m_policy.maxDelay){
+            flush();
+        }
+    }
+
+    void setFlushPolicy(const FlushPolicy& policy){
+        flush();
+        m_policy = policy;
+        m_buffer.reserve(policy.bufferSize);
+    }
+
+    const FlushPolicy& getFlushPolicy() const { return m_policy; }
+
+    // following files are written in compressed frames of blockSize bytes (see LogCompression); 0 -> no compression
+    // takes effect with next open(); entries are collected up to blockSize regardless of flush policy's bufferSize,
+    // but maxDelay and flushLevel still end a frame early
+    void setCompression(std::size_t blockSize){
+        m_compressBlockSize = std::min<std::size_t>(blockSize, 64 << 20);
+    }
+
+    bool isCompressed() const { return m_compressBlockSize > 0; }
+
+    const std::string& getPath() const { return m_path; }
+
+    bool isAppending() const { return m_isAppending; }
+
+    void setRotationPolicy(const RotationPolicy& policy){
+        m_rotation = policy;
+    }
+
+    // writes sidecar index <file>.idx along with the file (see LogTimeIndex); not possible for compressed files
+    bool setTimeIndex(std::size_t everyEntries, std::size_t everyBytes){
+        if(m_compressBlockSize > 0){
+            return false;
+        }
+        m_timeIndex.setInterval(everyEntries, everyBytes);
+        if(!m_timeIndex.isEnabled()){
+            m_timeIndex.close();
+            return true;
+        }
+        return !isOpen() || m_timeIndex.open(m_path, true, m_fileSize);
+    }
+
+    const RotationPolicy& getRotationPolicy() const { return m_rotation; }
+
+    // hands writes to io_uring (or LogIoPool) instead of writing them on the calling thread (see LogAsyncFile)
+    // must not be called while the sink is used by another thread; returns false if not available (Linux only)
+    bool setAsyncIo(const AsyncIoPolicy& policy){
+        #ifdef __linux__
+        flush();
+        m_async = std::make_unique<LogAsyncFile>(policy);
+        if(isOpen() && !attachAsync()){
+            m_async.reset();
+            return false;
+        }
+        return true;
+        #else
+        (void)policy;
+        return false;
+        #endif
+    }
+
+    // "io_uring", "pwrite pool" or "" for synchronous writes
+    const char* getAsyncBackend() const {
+        #ifdef __linux__
+        if(m_async){
+            return m_async->backendName();
+        }
+        #endif
+        return "";
+    }
+
+    // rotates file if it is too big or too old according to rotation policy; returns true if a new file has been started
+    // (done by whoever writes the entries, i.e. LogThreader for threaded loggers, so producers never wait for it)
+    bool rotateIfDue(){
+        if(!m_rotation.isEnabled() || !isOpen() || m_fileSize == 0 || LogCrashRegistry::isCrashing()){
+            return false;
+        }
+        bool tooBig = m_rotation.maxSize > 0 && m_fileSize >= m_rotation.maxSize;
+        bool tooOld = m_rotation.interval.count() > 0 && std::chrono::steady_clock::now() - m_openTime >= m_rotation.interval;
+        if(!tooBig && !tooOld){
+            return false;
+        }
+
+        rotate();
+        return true;
+    }
+
+    // path of n-th rotated file (0 -> current file)
+    std::string rotatedPath(std::size_t n) const {
+        if(n == 0){
+            return m_path;
+        }
+        fs::path path(m_path);
+        fs::path rotated = path.parent_path() / path.stem();
+        return rotated.string() + "." + std::to_string(n) + path.extension().string();
+    }
+
+    // may be called from any thread (counters are only written by the thread using the sink)
+    SinkStats getStats() const {
+        SinkStats stats;
+        stats.entries = m_stats.entries.load(std::memory_order_relaxed);
+        stats.bytes = m_stats.bytes.load(std::memory_order_relaxed);
+        stats.syscalls = m_stats.syscalls.load(std::memory_order_relaxed);
+        stats.flushes = m_stats.flushes.load(std::memory_order_relaxed);
+        stats.rotations = m_stats.rotations.load(std::memory_order_relaxed);
+        stats.uncompressedBytes = m_stats.uncompressedBytes.load(std::memory_order_relaxed);
+        stats.syncs = m_stats.syncs.load(std::memory_order_relaxed);
+        #ifdef __linux__
+        if(m_async){
+            stats.bytes += m_async->bytes();
+            stats.syscalls += m_async->syscalls();
+            stats.syncs += m_async->syncs();
+            stats.stalls = m_async->stalls();
+            stats.errors = m_async->errors();
+        }
+        #endif
+        return stats;
+    }
+
+private:
+
+    void requestSync(){
+        if(LogCrashRegistry::isCrashing()){
+            return;
+        }
+        m_isSyncDue = true;
+        if(!m_isGroupCommit){
+            commit();
+        }
+    }
+
+    // closes current file, shifts rotated files by one and starts with an empty file
+    void rotate(){
+        std::string path = m_path;
+        close();
+
+        std::error_code ec;
+        if(m_rotation.maxFiles == 0){
+            fs::remove(path, ec);
+        }
+        else{
+            fs::remove(rotatedPath(m_rotation.maxFiles), ec);
+            fs::remove(LogTimeIndex::pathOf(rotatedPath(m_rotation.maxFiles)), ec);
+            for(std::size_t i = m_rotation.maxFiles - 1; i > 0; --i){
+                fs::rename(rotatedPath(i), rotatedPath(i + 1), ec);
+                fs::rename(LogTimeIndex::pathOf(rotatedPath(i)), LogTimeIndex::pathOf(rotatedPath(i + 1)), ec);
+            }
+            fs::rename(path, rotatedPath(1), ec);
+            fs::rename(LogTimeIndex::pathOf(path), LogTimeIndex::pathOf(rotatedPath(1)), ec);
+        }
+
+        open(path, false);
+        count(m_stats.rotations);
+    }
+
+    void append(std::string_view msg, bool addNewline, LogLevel logLevel, std::int64_t timeNs=0){
+        if(!isOpen()){
+            return;
+        }
+        count(m_stats.entries);
+
+        // process is going down: no buffering and no compression (both may allocate), see LogCrashHandler
+        if(LogCrashRegistry::isCrashing()){
+            emergencyFlush();
+            if(m_compressBlockSize == 0){
+                m_fileSize += msg.size() + (addNewline ? 1 : 0);
+            }
+            writeEmergency(msg.data(), msg.size(), addNewline);
+            return;
+        }
+
+        std::size_t len = msg.size() + (addNewline ? 1 : 0);
+
+        if(m_compressBlockSize > 0){
+            appendCompressed(msg, addNewline, logLevel);
+            return;
+        }
+        if(addNewline && m_timeIndex.isOpen()){
+            m_timeIndex.add(m_fileSize, timeNs);
+        }
+        m_fileSize += len;
+        bool urgent = (int)logLevel <= m_policy.flushLevel;
+
+        if(m_policy.bufferSize == 0 || m_buffer.size() + len > m_policy.bufferSize){
+            // entry does not fit (or buffering disabled): write buffer and entry with a single vectored write
+            writeOut(m_buffer.data(), m_buffer.size(), msg.data(), msg.size(), addNewline);
+            m_buffer.clear();
+            return;
+        }
+
+        if(m_buffer.empty()){
+            m_firstBufferedTime = std::chrono::steady_clock::now();
+        }
+        m_buffer.append(msg.data(), msg.size());
+        if(addNewline){
+            m_buffer.push_back('\n');
+        }
+
+        if(urgent || m_buffer.size() >= m_policy.bufferSize){
+            flush();
+        }
+        else{
+            flushIfDue();
+        }
+    }
+
+    // collects entries of one frame, frame is compressed when full (or on flush)
+    void appendCompressed(std::string_view msg, bool addNewline, LogLevel logLevel){
+        std::int64_t timeNs = LogTimeFormatter::nowNs();
+        if(m_buffer.empty()){
+            m_firstBufferedTime = std::chrono::steady_clock::now();
+            m_frameFirstTimeNs = timeNs;
+            m_buffer.reserve(m_compressBlockSize);
+        }
+        m_frameLastTimeNs = timeNs;
+
+        m_buffer.append(msg.data(), msg.size());
+        if(addNewline){
+            m_buffer.push_back('\n');
+        }
+
+        if((int)logLevel <= m_policy.flushLevel || m_buffer.size() >= m_compressBlockSize){
+            flush();
+        }
+        else{
+            flushIfDue();
+        }
+    }
+
+    void writeFrame(){
+        LogCompression::compress(m_buffer.data(), m_buffer.size(), m_compressed);
+
+        LogCompression::FrameHeader header;
+        header.magic = LogCompression::s_frameMagic;
+        header.rawSize = (std::uint32_t)m_buffer.size();
+        header.flags = 0;
+        header.firstTimeNs = m_frameFirstTimeNs;
+        header.lastTimeNs = m_frameLastTimeNs;
+
+        const char* data = m_compressed.data();
+        if(m_compressed.size() >= m_buffer.size()){
+            header.flags = LogCompression::Stored;
+            data = m_buffer.data();
+        }
+        header.compressedSize = header.flags & LogCompression::Stored ? header.rawSize : (std::uint32_t)m_compressed.size();
+
+        m_index.push_back({m_fileOffset, header.firstTimeNs, header.lastTimeNs});
+        writeOut((const char*)&header, sizeof(header), data, header.compressedSize);
+
+        m_fileOffset += sizeof(header) + header.compressedSize;
+        m_fileSize = m_fileOffset;
+        count(m_stats.uncompressedBytes, header.rawSize);
+    }
+
+    // compressed files: data is written as stored frame which doesn't get into the index
+    // (no footer is written anyway; readers find frames by walking the headers then)
+    void writeEmergency(const char* data, std::size_t len, bool newline){
+        std::size_t rawLen = len + (newline ? 1 : 0);
+        if(m_compressBlockSize == 0){
+            writeOut(nullptr, 0, data, len, newline);
+            return;
+        }
+
+        LogCompression::FrameHeader header;
+        header.magic = LogCompression::s_frameMagic;
+        header.rawSize = (std::uint32_t)rawLen;
+        header.compressedSize = header.rawSize;
+        header.flags = LogCompression::Stored;
+        header.lastTimeNs = LogTimeFormatter::nowNs();
+        header.firstTimeNs = data == m_buffer.data() ? m_frameFirstTimeNs : header.lastTimeNs;
+
+        writeOut((const char*)&header, sizeof(header), data, len, newline);
+        m_fileOffset += sizeof(header) + rawLen;
+        m_fileSize = m_fileOffset;
+        count(m_stats.uncompressedBytes, rawLen);
+    }
+
+    void writeIndex(){
+        LogCompression::Footer footer;
+        footer.indexOffset = m_fileOffset;
+        footer.nFrames = (std::uint32_t)m_index.size();
+        footer.magic = LogCompression::s_footerMagic;
+
+        writeOut((const char*)m_index.data(), m_index.size() * sizeof(LogCompression::IndexEntry), (const char*)&footer, sizeof(footer));
+        m_index.clear();
+    }
+
+    #ifdef __linux__
+    // writes go to explicit offsets from now on, so that several can be in flight
+    bool attachAsync(){
+        int flags = fcntl(m_fd, F_GETFL);
+        off_t end = lseek(m_fd, 0, SEEK_END);
+        if(flags < 0 || end < 0 || fcntl(m_fd, F_SETFL, flags & ~O_APPEND) != 0){
+            return false;
+        }
+        return m_async->open(m_fd, (std::uint64_t)end);
+    }
+    #endif
+
+    // writes first and second chunk (and optionally a newline) in one go
+    void writeOut(const char* first, std::size_t firstLen, const char* second, std::size_t secondLen, bool newline=false){
+        count(m_stats.flushes);
+
+        #ifdef __linux__
+        if(m_async && m_async->isOpen()){
+            if(LogCrashRegistry::isCrashing()){
+                m_async->writeEmergency(first, firstLen, second, secondLen, newline);
+            }
+            else{
+                m_async->write(first, firstLen, second, secondLen, newline);
+            }
+            return;
+        }
+
+        static const char newlineChar = '\n';
+        struct iovec iov[3];
+        int iovCnt = 0;
+        if(firstLen > 0){
+            iov[iovCnt].iov_base = (void*)first;
+            iov[iovCnt++].iov_len = firstLen;
+        }
+        if(secondLen > 0){
+            iov[iovCnt].iov_base = (void*)second;
+            iov[iovCnt++].iov_len = secondLen;
+        }
+        if(newline){
+            iov[iovCnt].iov_base = (void*)&newlineChar;
+            iov[iovCnt++].iov_len = 1;
+        }
+
+        // writev may write less than requested; continue where it stopped
+        struct iovec* cur = iov;
+        while(iovCnt > 0){
+            ssize_t written = ::writev(m_fd, cur, iovCnt);
+            count(m_stats.syscalls);
+            if(written < 0){
+                if(errno == EINTR) continue;
+                m_hasWriteFailed = true;
+                return;     // nothing sensible left to do, entries are lost
+            }
+            count(m_stats.bytes, written);
+
+            while(iovCnt > 0 && (std::size_t)written >= cur->iov_len){
+                written -= cur->iov_len;
+                ++cur;
+                --iovCnt;
+            }
+            if(iovCnt > 0){
+                cur->iov_base = (char*)cur->iov_base + written;
+                cur->iov_len -= written;
+            }
+        }
+        #else
+        m_file.write(first, firstLen);
+        m_file.write(second, secondLen);
+        if(newline) m_file.put('\n');
+        m_file.flush();
+        count(m_stats.syscalls);
+        count(m_stats.bytes, firstLen + secondLen + (newline ? 1 : 0));
+        #endif
+    }
+
+    #ifdef __linux__
+    int m_fd = -1;
+    std::unique_ptr<LogAsyncFile> m_async;      // set -> writes are done asynchronously
+    #else
+    std::ofstream m_file;
+    #endif
+
+    FlushPolicy m_policy;
+    std::string m_buffer;
+    std::chrono::steady_clock::time_point m_firstBufferedTime;
+
+    std::size_t m_compressBlockSize = 0;
+    std::string m_compressed;                               // output buffer of compression
+    std::vector<LogCompression::IndexEntry> m_index;        // frames of current file
+    std::int64_t m_frameFirstTimeNs = 0;
+    std::int64_t m_frameLastTimeNs = 0;
+    std::uint64_t m_fileOffset = 0;                         // bytes in file (without buffered ones)
+
+    std::vector<LogDurabilityCallback> m_durabilityRequests;     // waiting for next commit
+    bool m_isSyncDue = false;           // next commit has to sync
+    bool m_isGroupCommit = false;
+    bool m_hasWriteFailed = false;      // since last commit
+
+    RotationPolicy m_rotation;
+    LogTimeIndexWriter m_timeIndex;
+    std::string m_path;
+    bool m_isAppending = false;
+    std::uint64_t m_fileSize = 0;       // including buffered bytes
+    std::chrono::steady_clock::time_point m_openTime;
+
+    // atomic, so that stats can be read while LogThreader writes; only one thread writes, so no atomic read-modify-write needed
+    struct Counters{
+        std::atomic<std::uint64_t> entries{0};
+        std::atomic<std::uint64_t> bytes{0};
+        std::atomic<std::uint64_t> syscalls{0};
+        std::atomic<std::uint64_t> flushes{0};
+        std::atomic<std::uint64_t> rotations{0};
+        std::atomic<std::uint64_t> uncompressedBytes{0};
+        std::atomic<std::uint64_t> syncs{0};
+    };
+
+    static void count(std::atomic<std::uint64_t>& counter, std::uint64_t n=1){
+        counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+
+    Counters m_stats;
+};
+
+#ifdef __linux__
+struct MappedSinkStats{
+    std::uint64_t entries = 0;      // entries written into mapping
+    std::uint64_t bytes = 0;        // bytes written into mapping
+    std::uint64_t regions = 0;      // regions mapped so far (first one included)
+};
+
+/* File output through a preallocated, memory mapped region of the file
+ * producers reserve space with an atomic fetch-add and copy their entries directly into the mapping,
+ * so there is neither a queue nor a syscall per entry; can be used by any number of threads at once
+ * if a region is full, the file grows by another region which gets mapped (old one is unmapped once all writers left it)
+ * crash safety: the last byte of every entry (newline) is written last, the unwritten preallocated space is zero,
+ * so incomplete entries always contain a NUL byte; readers keep only the part of a line after its last NUL byte
+ * (see CompleteLineReader in LogReader.hpp) */
+class MappedLogSink{
+public:
+    MappedLogSink(std::size_t regionSize = 64 << 20){
+        std::size_t pageSize = (std::size_t)sysconf(_SC_PAGESIZE);
+        m_regionSize = std::max(pageSize, (regionSize + pageSize - 1) / pageSize * pageSize);
+    }
+
+    ~MappedLogSink(){
+        close();
+    }
+
+    MappedLogSink(const MappedLogSink&) = delete;
+    MappedLogSink& operator=(const MappedLogSink&) = delete;
+
+    // opens file for appending; zero bytes left at end of file by a previous crash get overwritten
+    bool open(const std::string& path){
+        close();
+
+        m_fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        if(m_fd < 0){
+            return false;
+        }
+
+        std::uint64_t end = logicalEnd();
+        std::uint64_t pageSize = (std::uint64_t)sysconf(_SC_PAGESIZE);
+        std::uint64_t regionStart = end / pageSize * pageSize;
+
+        Region* region = mapRegion(regionStart);
+        if(region == nullptr){
+            ::close(m_fd);
+            m_fd = -1;
+            return false;
+        }
+        region->cursor.store(end - regionStart, std::memory_order_relaxed);
+        m_current.store(region, std::memory_order_seq_cst);
+        return true;
+    }
+
+    bool isOpen() const { return m_fd >= 0; }
+
+    // unmaps everything and cuts off preallocated space which has not been used
+    void close(){
+        if(m_fd < 0){
+            return;
+        }
+
+        // current region is null if mapping a new region failed, then the last one is full
+        Region* current = m_current.load(std::memory_order_seq_cst);
+        if(current == nullptr){
+            current = m_regions.back().get();
+        }
+        std::uint64_t end = current->fileOffset + std::min(current->cursor.load(), current->size);
+
+        for(std::unique_ptr<Region>& region : m_regions){
+            if(region->base != nullptr){
+                munmap(region->base, region->size);
+                region->base = nullptr;
+            }
+        }
+        m_regions.clear();
+        m_current.store(nullptr);
+
+        if(ftruncate(m_fd, (off_t)end) != 0){
+            // file keeps trailing zeros, which readers skip anyway
+        }
+        ::close(m_fd);
+        m_fd = -1;
+    }
+
+    // writes msg followed by newline
+    void write(std::string_view msg){
+        append(msg, true);
+    }
+
+    // writes msg as it is (should end with newline, else it counts as incomplete for readers)
+    void writeRaw(std::string_view msg){
+        append(msg, false);
+    }
+
+    MappedSinkStats getStats() const {
+        MappedSinkStats stats;
+        stats.entries = m_entries.load(std::memory_order_relaxed);
+        stats.bytes = m_bytes.load(std::memory_order_relaxed);
+        stats.regions = m_regionCount.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+    // writes back dirty pages of all regions (entries are in the page cache as soon as they have been copied)
+    bool sync(){
+        return m_fd >= 0 && ::fdatasync(m_fd) == 0;
+    }
+
+private:
+
+    struct Region{
+        char* base = nullptr;
+        std::uint64_t fileOffset = 0;
+        std::size_t size = 0;
+        std::atomic<std::size_t> cursor{0};     // next free byte (may grow beyond size, then region is full)
+        std::atomic<int> writers{0};            // producers currently copying into this region
+    };
+
+    void append(std::string_view msg, bool addNewline){
+        if(m_fd < 0){
+            return;
+        }
+
+        // entries longer than a region get cut
+        if(msg.size() + 1 > m_regionSize){
+            msg = msg.substr(0, m_regionSize - 1);
+            addNewline = true;
+        }
+        std::size_t len = msg.size() + (addNewline ? 1 : 0);
+        if(len == 0){
+            return;
+        }
+
+        while(true){
+            Region* region = m_current.load(std::memory_order_seq_cst);
+            if(region == nullptr){
+                return;     // mapping failed before, output is lost
+            }
+
+            // announce writer, then make sure region is still the current one (else it might get unmapped)
+            region->writers.fetch_add(1, std::memory_order_seq_cst);
+            if(region != m_current.load(std::memory_order_seq_cst)){
+                region->writers.fetch_sub(1, std::memory_order_release);
+                continue;
+            }
+
+            std::size_t pos = region->cursor.fetch_add(len, std::memory_order_relaxed);
+            if(pos + len <= region->size){
+                char* dest = region->base + pos;
+                std::size_t bodyLen = addNewline ? msg.size() : msg.size() - 1;
+                char last = addNewline ? '\n' : msg.back();
+
+                // last byte marks entry as complete, so it has to be written after everything else
+                std::memcpy(dest, msg.data(), bodyLen);
+                std::atomic_thread_fence(std::memory_order_release);
+                *(volatile char*)(dest + bodyLen) = last;
+
+                region->writers.fetch_sub(1, std::memory_order_release);
+                m_entries.fetch_add(1, std::memory_order_relaxed);
+                m_bytes.fetch_add(len, std::memory_order_relaxed);
+                return;
+            }
+
+            // rest of region becomes a line of spaces, so that files don't contain zero bytes between regions
+            // (done before leaving the region, as it might get unmapped afterwards)
+            if(pos < region->size){
+                char* dest = region->base + pos;
+                std::size_t gap = region->size - pos;
+                std::memset(dest, ' ', gap - 1);
+                std::atomic_thread_fence(std::memory_order_release);
+                *(volatile char*)(dest + gap - 1) = '\n';
+            }
+            region->writers.fetch_sub(1, std::memory_order_release);
+
+            if(pos <= region->size){
+                // this entry crossed the end of the region: its writer is responsible for the next one
+                rollOver(region);
+            }
+            else{
+                // somebody else is mapping the next region
+                while(m_current.load(std::memory_order_seq_cst) == region){
+                    #if ENABLE_MULTITHREADING
+                    std::this_thread::yield();
+                    #endif
+                }
+            }
+        }
+    }
+
+    void rollOver(Region* full){
+        // a new region may fill up before previous roll over is done
+        #if ENABLE_MULTITHREADING
+        std::lock_guard<std::mutex> lock(m_rollMutex);
+        #endif
+
+        Region* next = mapRegion(full->fileOffset + full->size);
+        m_current.store(next, std::memory_order_seq_cst);
+
+        // unmap regions nobody writes to anymore (writers can't enter them again, as they are not current)
+        for(std::unique_ptr<Region>& region : m_regions){
+            if(region.get() != next && region->base != nullptr && region->writers.load(std::memory_order_seq_cst) == 0){
+                munmap(region->base, region->size);
+                region->base = nullptr;
+            }
+        }
+    }
+
+    // preallocates and maps region starting at offset (has to be page aligned); returns nullptr on failure
+    Region* mapRegion(std::uint64_t offset){
+        if(fallocate(m_fd, 0, (off_t)offset, (off_t)m_regionSize) != 0){
+            // file system without fallocate support: grow file (sparse)
+            struct stat st;
+            if(fstat(m_fd, &st) != 0 || ((std::uint64_t)st.st_size < offset + m_regionSize && ftruncate(m_fd, (off_t)(offset + m_regionSize)) != 0)){
+                return nullptr;
+            }
+        }
+
+        void* base = mmap(nullptr, m_regionSize, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, (off_t)offset);
+        if(base == MAP_FAILED){
+            return nullptr;
+        }
+
+        // region structs are kept until close, so late writers can still safely look at their counters
+        std::unique_ptr<Region> region = std::make_unique<Region>();
+        region->base = (char*)base;
+        region->fileOffset = offset;
+        region->size = m_regionSize;
+        m_regions.push_back(std::move(region));
+        m_regionCount.fetch_add(1, std::memory_order_relaxed);
+        return m_regions.back().get();
+    }
+
+    // size of file without zero bytes at its end (preallocated space left by a crash)
+    std::uint64_t logicalEnd(){
+        struct stat st;
+        if(fstat(m_fd, &st) != 0){
+            return 0;
+        }
+        std::uint64_t end = (std::uint64_t)st.st_size;
+
+        char buffer[4096];
+        while(end > 0){
+            std::size_t chunk = (std::size_t)std::min<std::uint64_t>(end, sizeof(buffer));
+            if(pread(m_fd, buffer, chunk, (off_t)(end - chunk)) != (ssize_t)chunk){
+                break;
+            }
+            std::size_t i = chunk;
+            while(i > 0 && buffer[i - 1] == '\0') --i;
+            end -= chunk - i;
+            if(i > 0) break;
+        }
+        return end;
+    }
+
+    int m_fd = -1;
+    std::size_t m_regionSize;
+
+    std::atomic<Region*> m_current{nullptr};
+    std::vector<std::unique_ptr<Region>> m_regions;     // modified by open, close and rollOver (under m_rollMutex)
+    #if ENABLE_MULTITHREADING
+    std::mutex m_rollMutex;
+    #endif
+
+    std::atomic<std::uint64_t> m_entries{0};
+    std::atomic<std::uint64_t> m_bytes{0};
+    std::atomic<std::uint64_t> m_regionCount{0};
+};
+#endif
+
+// defines what happens if a log() call finds the queue of a threaded logger full
+enum class QueueOverflowPolicy {
+    Block,          // producer waits until LogThreader has made room (nothing gets lost)
+    DropNewest,     // new entry is discarded
+    DropOldest,     // oldest entry gets evicted once to make room; if still full, new entry is discarded
+    Overwrite       // oldest entries get evicted until new entry fits (newest entry always wins)
+};
+
+/* Bounded lock-free queue (multiple producers, consumer side may also be entered by several threads)
+ * based on Dmitry Vyukov's bounded MPMC queue: every slot carries a sequence number which tells
+ * producers and consumers whose turn it is, so no lock is needed on either side */
+template<typename T>
+class LogRing{
+public:
+    LogRing(std::size_t capacity, QueueOverflowPolicy policy=QueueOverflowPolicy::Block)
+        :m_policy(policy)
+    {
+        // capacity has to be a power of two, so that position can be mapped to slot by masking
+        std::size_t size = 2;
+        while(size < capacity){
+            size <<= 1;
+        }
+        m_capacity = size;
+        m_mask = size - 1;
+
+        m_slots = std::make_unique<Slot[]>(size);
+        for(std::size_t i = 0; i < size; ++i){
+            m_slots[i].seq.store(i, std::memory_order_relaxed);
+        }
+        m_enqueuePos.store(0, std::memory_order_relaxed);
+        m_dequeuePos.store(0, std::memory_order_relaxed);
+    }
+
+    LogRing(const LogRing&) = delete;
+    LogRing& operator=(const LogRing&) = delete;
+
+    // adds item according to overflow policy; returns false if the passed item has been discarded
+    bool push(T&& item){
+
+        if(tryPush(item)) return true;
+
+        switch(m_policy.load(std::memory_order_relaxed)){
+        case QueueOverflowPolicy::Block:
+            while(!tryPush(item)){
+                #if ENABLE_MULTITHREADING
+                std::this_thread::yield();
+                #endif
+            }
+            return true;
+
+        case QueueOverflowPolicy::DropNewest:
+            m_droppedNewest.fetch_add(1, std::memory_order_relaxed);
+            return false;
+
+        case QueueOverflowPolicy::DropOldest:
+            evictOldest();
+            if(tryPush(item)) return true;
+            m_droppedNewest.fetch_add(1, std::memory_order_relaxed);
+            return false;
+
+        case QueueOverflowPolicy::Overwrite:
+            do{
+                evictOldest();
+            } while(!tryPush(item));
+            return true;
+        }
+
+        return false;
+    }
+
+    // removes oldest item and writes it into item; returns false if queue was empty
+    bool pop(T& item){
+        Slot* slot;
+        std::size_t pos = m_dequeuePos.load(std::memory_order_relaxed);
+
+        while(true){
+            slot = &m_slots[pos & m_mask];
+            std::size_t seq = slot->seq.load(std::memory_order_acquire);
+            std::intptr_t diff = (std::intptr_t)seq - (std::intptr_t)(pos + 1);
+
+            if(diff == 0){
+                if(m_dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            }
+            else if(diff < 0){
+                return false;   // empty
+            }
+            else{
+                pos = m_dequeuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        item = std::move(slot->data);
+        slot->seq.store(pos + m_mask + 1, std::memory_order_release);
+        return true;
+    }
+
+    // approximate amount of items (exact if no producer or consumer is active at the same time)
+    std::size_t size() const {
+        std::size_t enq = m_enqueuePos.load(std::memory_order_acquire);
+        std::size_t deq = m_dequeuePos.load(std::memory_order_acquire);
+        return enq > deq ? enq - deq : 0;
+    }
+
+    bool empty() const { return size() == 0; }
+
+    std::size_t capacity() const { return m_capacity; }
+
+    void setPolicy(QueueOverflowPolicy policy){ m_policy.store(policy, std::memory_order_relaxed); }
+    QueueOverflowPolicy getPolicy() const { return m_policy.load(std::memory_order_relaxed); }
+
+    // amount of new items which were discarded because queue was full
+    std::uint64_t getDroppedNewest() const { return m_droppedNewest.load(std::memory_order_relaxed); }
+
+    // amount of queued items which were evicted to make room for new ones
+    std::uint64_t getDroppedOldest() const { return m_droppedOldest.load(std::memory_order_relaxed); }
+
+private:
+
+    struct Slot{
+        std::atomic<std::size_t> seq;
+        T data;
+    };
+
+    // tries to insert item once; item is only moved from on success
+    bool tryPush(T& item){
+        Slot* slot;
+        std::size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+
+        while(true){
+            slot = &m_slots[pos & m_mask];
+            std::size_t seq = slot->seq.load(std::memory_order_acquire);
+            std::intptr_t diff = (std::intptr_t)seq - (std::intptr_t)pos;
+
+            if(diff == 0){
+                if(m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            }
+            else if(diff < 0){
+                return false;   // full
+            }
+            else{
+                pos = m_enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        slot->data = std::move(item);
+        slot->seq.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // producer takes over consumer role for one item and discards it
+    void evictOldest(){
+        T victim;
+        if(pop(victim)){
+            m_droppedOldest.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    std::unique_ptr<Slot[]> m_slots;
+    std::size_t m_capacity;
+    std::size_t m_mask;
+
+    std::atomic<QueueOverflowPolicy> m_policy;
+
+    // producers and consumer positions on separate cache lines, so they don't invalidate each other
+    alignas(64) std::atomic<std::size_t> m_enqueuePos;
+    alignas(64) std::atomic<std::size_t> m_dequeuePos;
+
+    alignas(64) std::atomic<std::uint64_t> m_droppedNewest{0};
+    std::atomic<std::uint64_t> m_droppedOldest{0};
+};
+
+/* Bounded lock-free queue for exactly one producer and one consumer thread
+ * both sides only write their own position, the position of the other side is cached and only reloaded if necessary */
+template<typename T>
+class LogSpscRing{
+public:
+    LogSpscRing(std::size_t capacity){
+        std::size_t size = 2;
+        while(size < capacity){
+            size <<= 1;
+        }
+        m_capacity = size;
+        m_mask = size - 1;
+        m_slots = std::make_unique<T[]>(size);
+    }
+
+    LogSpscRing(const LogSpscRing&) = delete;
+    LogSpscRing& operator=(const LogSpscRing&) = delete;
+
+    // producer: adds item; returns false (item untouched) if queue is full
+    bool tryPush(T& item){
+        std::size_t tail = m_tail.load(std::memory_order_relaxed);
+        if(tail - m_headCache == m_capacity){
+            m_headCache = m_head.load(std::memory_order_acquire);
+            if(tail - m_headCache == m_capacity){
+                return false;
+            }
+        }
+        m_slots[tail & m_mask] = std::move(item);
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // consumer: oldest item (stays in queue until popFront), nullptr if empty
+    T* front(){
+        std::size_t head = m_head.load(std::memory_order_relaxed);
+        if(head == m_tailCache){
+            m_tailCache = m_tail.load(std::memory_order_acquire);
+            if(head == m_tailCache){
+                return nullptr;
+            }
+        }
+        return &m_slots[head & m_mask];
+    }
+
+    // consumer: removes item returned by front() (after it has been moved out)
+    void popFront(){
+        m_head.store(m_head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    // approximate amount of queued items (may be called from any thread)
+    std::size_t size() const {
+        std::size_t head = m_head.load(std::memory_order_acquire);
+        std::size_t tail = m_tail.load(std::memory_order_acquire);
+        return tail >= head ? tail - head : 0;
+    }
+
+    bool empty() const { return size() == 0; }
+
+    std::size_t capacity() const { return m_capacity; }
+
+private:
+    std::unique_ptr<T[]> m_slots;
+    std::size_t m_capacity;
+    std::size_t m_mask;
+
+    alignas(64) std::atomic<std::size_t> m_head{0};     // written by consumer
+    std::size_t m_tailCache = 0;                        // consumer's copy of m_tail
+
+    alignas(64) std::atomic<std::size_t> m_tail{0};     // written by producer
+    std::size_t m_headCache = 0;                        // producer's copy of m_head
+};
+
+class LogEntryPoolBase{
+public:
+    virtual ~LogEntryPoolBase(){}
+
+    // takes back entry which is not needed anymore
+    virtual void release(LogEntry* entry) = 0;
+};
+
+// deleter of LogEntryPtr: gives entry back to the pool it came from (or deletes it if it didn't come from a pool)
+struct LogEntryRecycler{
+    LogEntryRecycler(LogEntryPoolBase* pool=nullptr)
+        :m_pool(pool)
+    {}
+
+    // allows to pass entries created with std::make_unique
+    template<typename T>
+    LogEntryRecycler(const std::default_delete<T>&)
+        :m_pool(nullptr)
+    {}
+
+    void operator()(LogEntry* entry) const {
+        if(m_pool != nullptr){
+            m_pool->release(entry);
+        }
+        else{
+            delete entry;
+        }
+    }
+
+    LogEntryPoolBase* m_pool;
+};
+
+using LogEntryPtr = std::unique_ptr<LogEntry, LogEntryRecycler>;
+
+/* Recycles entries of one type, so that steady-state logging does not need the heap:
+ * entries (including the capacity of their strings) are reused after they have been written
+ * pool starts empty and keeps up to capacity entries which have been given back */
+template<typename Entry>
+class LogEntryPool : public LogEntryPoolBase{
+public:
+    LogEntryPool(std::size_t capacity)
+        :m_free(capacity, QueueOverflowPolicy::DropNewest)
+    {}
+
+    ~LogEntryPool(){
+        Entry* entry;
+        while(m_free.pop(entry)){
+            delete entry;
+        }
+    }
+
+    // returns recycled entry initialized with args (or new one if pool is empty)
+    template<typename... Args>
+    std::unique_ptr<Entry, LogEntryRecycler> acquire(const Args&... args){
+        Entry* entry;
+        if(m_free.pop(entry)){
+            entry->assign(args...);
+        }
+        else{
+            entry = new Entry(args...);
+            m_misses.fetch_add(1, std::memory_order_relaxed);
+        }
+        return std::unique_ptr<Entry, LogEntryRecycler>(entry, LogEntryRecycler(this));
+    }
+
+    void release(LogEntry* entry) override{
+        Entry* recycled = static_cast<Entry*>(entry);
+        if(!m_free.push(std::move(recycled))){
+            delete recycled;    // pool is full
+        }
+    }
+
+    // amount of entries which had to be allocated because pool was empty
+    std::uint64_t getMisses() const { return m_misses.load(std::memory_order_relaxed); }
+
+private:
+    LogRing<Entry*> m_free;
+    std::atomic<std::uint64_t> m_misses{0};
+};
+
+#if ENABLE_MULTITHREADING
+/* Wakeup channel between producers (log calls) and LogThreader
+ * LogThreader sleeps on it while all queues are empty; producers only pay for a notification if
+ * the threader is actually sleeping */
+class LogSignal{
+public:
+    // called by producers after enqueuing
+    void notify(){
+        // pairs with fence in wait(): either threader sees the new entry or we see that it's sleeping
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if(m_waiting.load(std::memory_order_relaxed)){
+            wake();
+        }
+    }
+
+    // wakes consumer unconditionally (e.g. for shutdown)
+    void wake(){
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_pending = true;
+        m_cv.notify_all();
+    }
+
+    // blocks until notified or timeout expired
+    // hasWork is evaluated after announcing the wait, so that no notification can get lost in between
+    template<typename Predicate>
+    void wait(std::chrono::microseconds timeout, Predicate hasWork){
+        m_waiting.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        if(!hasWork()){
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_cv.wait_for(lock, timeout, [this]{ return m_pending; });
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_pending = false;
+        m_waiting.store(false, std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<bool> m_waiting{false};
+
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    bool m_pending = false;         // guarded by m_mutex
+};
+
+struct ConsoleSinkStats{
+    std::uint64_t messages = 0;     // messages accepted
+    std::uint64_t dropped = 0;      // messages discarded because buffer was full
+    std::uint64_t writes = 0;       // batches written to stream
+    std::uint64_t bytes = 0;
+};
+
+/* Console output on a background thread: messages are collected in a bounded buffer and written in large batches
+ * callers only copy their message (or drop it if the buffer is full), so a slow terminal or pipe never blocks them
+ * batches are written while holding consoleMutex, so they interleave line by line with other console output */
+class LogConsoleSink{
+public:
+    enum Stream { Stdout, Stderr };
+
+    // one sink per stream, started on first use
+    static LogConsoleSink& instance(Stream stream = Stdout){
+        static LogConsoleSink outSink(Stdout);
+        static LogConsoleSink errSink(Stderr);
+        return stream == Stderr ? errSink : outSink;
+    }
+
+    ~LogConsoleSink(){
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_running = false;
+        }
+        m_cv.notify_all();
+        if(m_thread.joinable()){
+            m_thread.join();
+        }
+    }
+
+    LogConsoleSink(const LogConsoleSink&) = delete;
+    LogConsoleSink& operator=(const LogConsoleSink&) = delete;
+
+    // queues msg followed by newline; returns false if it had to be dropped
+    bool write(std::string_view msg){
+        bool wasEmpty;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if(!m_running){
+                return false;
+            }
+            if(m_pending.size() + msg.size() + 1 > m_capacity){
+                ++m_dropped;
+                ++m_stats.dropped;
+                return false;
+            }
+            wasEmpty = m_pending.empty();
+            m_pending.append(msg.data(), msg.size());
+            m_pending.push_back('\n');
+            ++m_stats.messages;
+            if(!m_thread.joinable()){
+                m_thread = std::thread(&LogConsoleSink::writing, this);
+            }
+        }
+
+        // writer only sleeps if there is nothing pending
+        if(wasEmpty){
+            m_cv.notify_one();
+        }
+        return true;
+    }
+
+    // blocks until everything queued so far has been written
+    void flush(){
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_flushed.wait(lock, [this]{ return (m_pending.empty() && !m_isWriting) || !m_running; });
+    }
+
+    // bytes which may wait for output; further messages are dropped (should be set before first use)
+    void setCapacity(std::size_t capacity){
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_capacity = capacity;
+    }
+
+    ConsoleSinkStats getStats(){
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_stats;
+    }
+
+private:
+    LogConsoleSink(Stream stream)
+        :m_stream(stream == Stderr ? std::cerr : std::cout)
+    {}
+
+    void writing(){
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while(true){
+            m_cv.wait(lock, [this]{ return !m_pending.empty() || !m_running; });
+            if(m_pending.empty() && !m_running){
+                break;
+            }
+
+            // take everything collected so far, callers continue with an empty buffer meanwhile
+            m_writing.swap(m_pending);
+            std::uint64_t dropped = m_dropped;
+            m_dropped = 0;
+            m_isWriting = true;
+            lock.unlock();
+
+            if(dropped > 0){
+                m_writing += "LogConsoleSink WARNING: " + std::to_string(dropped) + " messages dropped (console too slow)\n";
+            }
+            consoleMutex.lock();
+            m_stream.write(m_writing.data(), (std::streamsize)m_writing.size());
+            m_stream.flush();
+            consoleMutex.unlock();
+
+            lock.lock();
+            ++m_stats.writes;
+            m_stats.bytes += m_writing.size();
+            m_writing.clear();
+            m_isWriting = false;
+            m_flushed.notify_all();
+        }
+        m_flushed.notify_all();
+    }
+
+    std::ostream& m_stream;
+    std::thread m_thread;
+
+    std::mutex m_mutex;                 // guards everything below (never held while writing to stream)
+    std::condition_variable m_cv;
+    std::condition_variable m_flushed;
+    std::string m_pending;              // messages collected since last batch
+    std::string m_writing;              // batch currently written
+    std::size_t m_capacity = 1 << 20;
+    std::uint64_t m_dropped = 0;        // dropped since last batch
+    bool m_isWriting = false;
+    bool m_running = true;
+    ConsoleSinkStats m_stats;
+};
+
+/* Queue of one producing thread for one logger (see Logger::enableThreadBuffers)
+ * entries carry a time stamp, so that the consumer can merge the queues of all threads into one ordered stream */
+struct LogThreadBuffer{
+    struct Item{
+        std::uint64_t timeNs = 0;       // steady clock, only used for ordering
+        LogEntryPtr entry;
+    };
+
+    LogThreadBuffer(std::size_t capacity)
+        :ring(capacity)
+    {}
+
+    static std::uint64_t now(){
+        return (std::uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    LogSpscRing<Item> ring;
+    std::atomic<bool> retired{false};       // producing thread has exited, buffer can be removed once it is empty
+    std::atomic<bool> detached{false};      // logger has been destroyed, producing thread can forget buffer
+};
+
+// buffers of the calling thread, one per logger it has logged to; retires them when thread exits
+struct LogThreadBufferRegistry{
+    ~LogThreadBufferRegistry(){
+        for(auto& buffer : buffers){
+            buffer.second->retired.store(true, std::memory_order_release);
+        }
+    }
+
+    // forgets buffers of destroyed loggers
+    void prune(){
+        buffers.erase(std::remove_if(buffers.begin(), buffers.end(), [](const auto& buffer){
+            return buffer.second->detached.load(std::memory_order_acquire);
+        }), buffers.end());
+    }
+
+    std::vector<std::pair<std::uint64_t, std::shared_ptr<LogThreadBuffer>>> buffers;    // logger id -> buffer
+};
+#endif
+
+// limits how often a single log statement gets written (see Logger::setRateLimit and LOG_LIMITED)
+struct LogRateLimit{
+    double perSecond = 0;                               // sustained rate (token bucket); 0 -> no rate limit
+    std::uint32_t burst = 1;                            // messages which may pass at once after a quiet period
+    std::uint32_t sampleEvery = 1;                      // only every n-th message is considered (1 -> all)
+    std::chrono::milliseconds summaryInterval{1000};    // suppressed messages are reported at most this often
+
+    static LogRateLimit rate(double perSecond, std::uint32_t burst = 1){
+        LogRateLimit limit;
+        limit.perSecond = perSecond;
+        limit.burst = std::max<std::uint32_t>(burst, 1);
+        return limit;
+    }
+
+    static LogRateLimit sampled(std::uint32_t every){
+        LogRateLimit limit;
+        limit.sampleEvery = std::max<std::uint32_t>(every, 1);
+        return limit;
+    }
+
+    bool isEnabled() const { return perSecond > 0 || sampleEvery > 1; }
+};
+
+/* State of one log statement, created as static by LOG_<LEVEL> macros (shared by all loggers used in that statement)
+ * token bucket is kept as "theoretical arrival time" (GCRA), so that check and update are a single CAS */
+class LogCallSite{
+public:
+    // suppressed messages which are due to be reported
+    struct Summary{
+        std::uint64_t suppressed = 0;
+        double seconds = 0;
+        bool isFirst = false;       // first message suppressed since last summary (see Logger::reportPendingSuppressed)
+    };
+
+    LogCallSite(const char* file, int line, const LogRateLimit* limit = nullptr)
+        :m_file(file), m_line(line), m_limit(limit)
+    {}
+
+    // true if message may be written; summary gets set if suppressed messages should be reported now
+    bool allow(const LogRateLimit& limit, Summary& summary){
+        bool isAllowed = true;
+        if(limit.sampleEvery > 1 && m_count.fetch_add(1, std::memory_order_relaxed) % limit.sampleEvery != 0){
+            isAllowed = false;
+        }
+
+        std::int64_t now = 0;
+        if(isAllowed && limit.perSecond > 0){
+            now = nowNs();
+            isAllowed = takeToken(limit, now);
+        }
+
+        if(!isAllowed && m_suppressed.fetch_add(1, std::memory_order_relaxed) == 0){
+            // window starts with the flood, not at last summary (which may have been long ago)
+            summary.isFirst = true;
+            m_windowStart.store(now != 0 ? now : nowNs(), std::memory_order_relaxed);
+        }
+        else if(m_suppressed.load(std::memory_order_relaxed) != 0){
+            collectSummary(limit, now != 0 ? now : nowNs(), summary);
+        }
+        return isAllowed;
+    }
+
+    // own limit (LOG_LIMITED) or nullptr if limits of logger apply
+    const LogRateLimit* getLimit() const { return m_limit; }
+
+    // file name (without directories) and line of log statement
+    std::string_view getFile() const {
+        std::string_view file(m_file);
+        std::size_t slash = file.find_last_of("/\\");
+        return slash == std::string_view::npos ? file : file.substr(slash + 1);
+    }
+
+    int getLine() const { return m_line; }
+
+    // suppressed and not yet reported
+    std::uint64_t getSuppressed() const { return m_suppressed.load(std::memory_order_relaxed); }
+
+    // sets summary if suppressed messages are due to be reported (force -> even if summaryInterval hasn't passed yet)
+    // for statements which don't run anymore, e.g. after a flood has stopped
+    void collectPending(const LogRateLimit& limit, bool force, Summary& summary){
+        if(m_suppressed.load(std::memory_order_relaxed) != 0){
+            collectSummary(limit, nowNs(), summary, force);
+        }
+    }
+
+    // text of the warning reporting suppressed messages
+    std::string describe(const Summary& summary) const {
+        char seconds[32];
+        std::to_chars_result result = std::to_chars(seconds, seconds + sizeof(seconds), summary.seconds, std::chars_format::fixed, 1);
+        return "message at " + std::string(getFile()) + ":" + std::to_string(getLine()) + " suppressed "
+             + std::to_string(summary.suppressed) + " times in last " + std::string(seconds, result.ptr - seconds) + " s";
+    }
+
+private:
+    // coarse clock is enough here and costs only a few ns
+    static std::int64_t nowNs(){
+        #ifdef __linux__
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+        return (std::int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+        #else
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        #endif
+    }
+
+    bool takeToken(const LogRateLimit& limit, std::int64_t now){
+        std::int64_t interval = (std::int64_t)(1e9 / limit.perSecond);
+        std::int64_t tolerance = interval * (std::int64_t)(std::max<std::uint32_t>(limit.burst, 1) - 1);
+        std::int64_t arrival = m_arrival.load(std::memory_order_relaxed);
+        while(true){
+            std::int64_t start = std::max(arrival, now);
+            if(start - now > tolerance){
+                return false;
+            }
+            if(m_arrival.compare_exchange_weak(arrival, start + interval, std::memory_order_relaxed)){
+                return true;
+            }
+        }
+    }
+
+    // one thread per interval wins the window and takes the count
+    void collectSummary(const LogRateLimit& limit, std::int64_t now, Summary& summary, bool force=false){
+        std::int64_t windowStart = m_windowStart.load(std::memory_order_relaxed);
+        if(windowStart == 0 && !force){
+            m_windowStart.compare_exchange_strong(windowStart, now, std::memory_order_relaxed);
+            return;
+        }
+        std::int64_t intervalNs = (std::int64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(limit.summaryInterval).count();
+        if((!force && now - windowStart < intervalNs) || !m_windowStart.compare_exchange_strong(windowStart, now, std::memory_order_relaxed)){
+            return;
+        }
+        summary.suppressed = m_suppressed.exchange(0, std::memory_order_relaxed);
+        summary.seconds = windowStart != 0 ? (double)(now - windowStart) * 1e-9 : 0;
+    }
+
+    const char* m_file;
+    int m_line;
+    const LogRateLimit* m_limit;
+
+    std::atomic<std::int64_t> m_arrival{0};         // time at which bucket is full again
+    std::atomic<std::uint64_t> m_count{0};          // calls, for sampling
+    std::atomic<std::uint64_t> m_suppressed{0};     // since last summary
+    std::atomic<std::int64_t> m_windowStart{0};     // time of last summary or of first suppression after it
+};
+
+// logger class
+class Logger{
+public:
+    Logger(bool enableConsolePrinting=false)
+        :m_enableConsolePrinting(enableConsolePrinting), m_isHandledByThreader(false)
+    {
+        #if ENABLE_MULTITHREADING
+        m_logEntries = std::make_unique<LogRing<LogEntryPtr>>(s_defaultQueueCapacity);
+        #endif
+        LogCrashRegistry::add(this);
+    }
+
+    ~Logger(){
+        LogCrashRegistry::remove(this);
+
+        #if ENABLE_MULTITHREADING
+        // buffers may outlive logger (owned by producing threads too), but their entries belong to our pools
+        std::lock_guard<std::mutex> lock(m_threadBuffersMutex);
+        for(auto& buffer : m_threadBuffers){
+            buffer->detached.store(true, std::memory_order_release);
+            while(LogThreadBuffer::Item* item = buffer->ring.front()){
+                item->entry.reset();
+                buffer->ring.popFront();
+            }
+        }
+        #endif
+
+        m_sink.close();
+
+        // remove logfile from s_openLogFiles
+        s_openLogFiles.erase(std::find(s_openLogFiles.begin(), s_openLogFiles.end(), m_logFilePath));
+    }
+
+    bool isHandledByThreader() { return m_isHandledByThreader.load(std::memory_order_acquire); }
+
+    // defines how entries get buffered before being written to file (default: every entry is written immediately)
+    // should be set before logger is handed over to LogThreader
+    void setFlushPolicy(const FlushPolicy& policy){ m_sink.setFlushPolicy(policy); }
+
+    // writes log file compressed in independent frames to <file>.lz4 (see LogCompression); compression is done by the
+    // thread writing the entries (LogThreader for threaded loggers); has to be called before logger is handed over to LogThreader
+    // not possible for .ccol files and memory mapped output; returns false then
+    bool enableCompression(std::size_t blockSize = 64 << 10){
+        if(m_logFilePath.size() > 5 && m_logFilePath.substr(m_logFilePath.size()-5, 5) == ".ccol"){
+            return false;
+        }
+        #ifdef __linux__
+        if(m_mappedSink){
+            return false;
+        }
+        #endif
+        if(isHandledByThreader() || blockSize == 0 || m_sink.isCompressed()){
+            return false;
+        }
+
+        std::string path = m_sink.getPath();
+        if(path.empty()){
+            return false;
+        }
+        bool append = m_sink.isAppending();
+        m_sink.close();
+
+        // if uncompressed file only holds what this logger wrote so far (e.g. start message, header), it is moved over
+        std::string written;
+        std::error_code ec;
+        if(fs::file_size(path, ec) == m_sink.getStats().bytes && !ec){
+            std::ifstream file(path, std::ios::in | std::ios::binary);
+            written.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+            file.close();
+            fs::remove(path, ec);
+        }
+
+        m_sink.setCompression(blockSize);
+        if(!m_sink.open(path + ".lz4", append)){
+            return false;
+        }
+        if(!written.empty()){
+            m_sink.writeRaw(written);
+        }
+        else{
+            writeFileHeader();
+        }
+        return true;
+    }
+
+    // starts new files by size and/or age and keeps a limited amount of old ones (see RotationPolicy)
+    // not possible for .ccol files (index is written at the end) and memory mapped output; returns false then
+    bool setRotationPolicy(const RotationPolicy& policy){
+        if(m_logFilePath.size() > 5 && m_logFilePath.substr(m_logFilePath.size()-5, 5) == ".ccol"){
+            return false;
+        }
+        #ifdef __linux__
+        if(m_mappedSink){
+            return false;
+        }
+        #endif
+        m_sink.setRotationPolicy(policy);
+        return true;
+    }
+
+    // writes sidecar time index <file>.idx (a point every everyEntries entries or everyBytes bytes), so that
+    // IndexedLogReader and "logtool slice" can seek to a time range; .log and .csv files only
+    // not possible for .ccol and .blog files, compressed files and memory mapped output; returns false then
+    bool enableTimeIndex(std::size_t everyEntries = 1000, std::size_t everyBytes = 64 << 10){
+        for(const char* ending : {".ccol", ".blog"}){
+            if(m_logFilePath.size() > 5 && m_logFilePath.substr(m_logFilePath.size()-5, 5) == ending){
+                return false;
+            }
+        }
+        #ifdef __linux__
+        if(m_mappedSink){
+            return false;
+        }
+        #endif
+        return m_sink.setTimeIndex(everyEntries, everyBytes);
+    }
+
+    // writes file output asynchronously (Linux): io_uring if available, else pwrite on LogIoPool threads
+    // the thread writing entries (LogThreader) only copies data into one of policy.depth buffers, so a slow
+    // disk no longer stalls the other loggers it serves; call before addLogger (returns false then)
+    // not possible for memory mapped output; returns false if no backend is available
+    bool enableAsyncIo(const AsyncIoPolicy& policy = AsyncIoPolicy()){
+        #ifdef __linux__
+        if(m_mappedSink){
+            return false;
+        }
+        #endif
+        if(isHandledByThreader()){
+            return false;
+        }
+        return m_sink.setAsyncIo(policy);
+    }
+
+    // backend used for file output: "io_uring", "pwrite pool" or "" (synchronous)
+    const char* getAsyncBackend() const { return m_sink.getAsyncBackend(); }
+
+    // write counters of file output
+    SinkStats getSinkStats() const { return m_sink.getStats(); }
+
+    // requests that everything logged so far reaches the OS (flush) or the disk (sync: fdatasync)
+    // loggers handled by LogThreader queue a barrier behind the entries logged so far; the request is satisfied once
+    // the worker has written them, and all requests of a batch share one fdatasync (group commit); other loggers
+    // satisfy it right away. done runs on the thread writing the entries and should return quickly; it gets false
+    // if writing or syncing failed (or the barrier has been dropped because the queue was full)
+    void flush(LogDurabilityCallback done){
+        requestDurability(false, std::move(done));
+    }
+
+    void sync(LogDurabilityCallback done){
+        requestDurability(true, std::move(done));
+    }
+
+    #if ENABLE_MULTITHREADING
+    // same with a future, e.g. logger->sync().get() blocks until all entries logged before are on disk
+    std::future<bool> flush(){
+        return requestDurability(false);
+    }
+
+    std::future<bool> sync(){
+        return requestDurability(true);
+    }
+    #endif
+
+    // limits messages of given level per log statement (LOG_<LEVEL> macros only; each statement has its own budget)
+    // suppressed messages are counted and reported as warning at most once per summaryInterval and statement
+    // a disabled limit (LogRateLimit()) removes it again; should not be called from several threads at once
+    void setRateLimit(LogLevel logLevel, const LogRateLimit& limit){
+        // every level has two slots, new limit goes into the one not in use, as logging threads may still look at current one
+        const LogRateLimit* current = nullptr;
+        if(limit.isEnabled()){
+            std::array<LogRateLimit, 2>& slots = m_rateLimitSlots[logLevel];
+            LogRateLimit* slot = m_rateLimits[logLevel].load(std::memory_order_relaxed) == &slots[0] ? &slots[1] : &slots[0];
+            *slot = limit;
+            current = slot;
+        }
+        m_rateLimits[logLevel].store(current, std::memory_order_release);
+
+        bool hasRateLimits = false;
+        for(const std::atomic<const LogRateLimit*>& rateLimit : m_rateLimits){
+            hasRateLimits = hasRateLimits || rateLimit.load(std::memory_order_relaxed) != nullptr;
+        }
+        m_hasRateLimits.store(hasRateLimits, std::memory_order_release);
+    }
+
+    // called by LOG_<LEVEL> macros: true if message of call site may be written now
+    bool allowCallSite(LogCallSite& site, LogLevel logLevel){
+        const LogRateLimit* limit = site.getLimit();
+        if(limit == nullptr){
+            if(!m_hasRateLimits.load(std::memory_order_relaxed)){
+                return true;
+            }
+            limit = m_rateLimits[logLevel].load(std::memory_order_acquire);
+            if(limit == nullptr){
+                return true;
+            }
+        }
+
+        LogCallSite::Summary summary;
+        bool isAllowed = site.allow(*limit, summary);
+        if(summary.isFirst){
+            watchCallSite(site, logLevel);
+        }
+        if(summary.suppressed > 0){
+            reportSuppressed(site.describe(summary));
+        }
+        return isAllowed;
+    }
+
+    // reports messages suppressed by call sites which haven't run again since (otherwise the count of a flood's last
+    // window would never show up); done by LogThreader when it wakes up and on flush, sync and shutdown (force)
+    void reportPendingSuppressed(bool force){
+        std::vector<std::string> msgs;
+        {
+            std::lock_guard<std::mutex> lock(m_suppressingSitesMutex);
+            for(const std::pair<LogCallSite*, LogLevel>& watched : m_suppressingSites){
+                LogCallSite& site = *watched.first;
+                if(site.getSuppressed() == 0){
+                    continue;
+                }
+                // limit might have been removed meanwhile, then count is reported right away
+                const LogRateLimit* limit = site.getLimit();
+                if(limit == nullptr){
+                    limit = m_rateLimits[watched.second].load(std::memory_order_acquire);
+                }
+                LogCallSite::Summary summary;
+                site.collectPending(limit != nullptr ? *limit : LogRateLimit(), force || limit == nullptr, summary);
+                if(summary.suppressed > 0){
+                    msgs.push_back(site.describe(summary));
+                }
+            }
+        }
+        for(const std::string& msg : msgs){
+            reportSuppressed(msg);
+        }
+    }
+
+protected:
+
+    // creates pool for entries of given type; pool lives as long as logger
+    template<typename Entry>
+    LogEntryPool<Entry>* createEntryPool(){
+        m_entryPools.push_back(std::make_unique<LogEntryPool<Entry>>(s_defaultQueueCapacity + 64));
+        return static_cast<LogEntryPool<Entry>*>(m_entryPools.back().get());
+    }
+
+    // pools have to be destroyed after queue (which may still hold pooled entries), so they are declared first
+    std::vector<std::unique_ptr<LogEntryPoolBase>> m_entryPools;
+
+    bool m_enableConsolePrinting;
+
+    std::string m_logFilePath;
+    LogFileSink m_sink;
+
+    // method to intialize file
+    void setup(std::string logFileName, bool logFileNameIsAbsolutePath){
+
+        std::string logFileDir;
+        std::string dirSeparator;
+        
+        #ifdef __linux__
+        dirSeparator = std::string("/");
+        #elif _WIN32
+        dirSeparator = std::string("\\");
+        #endif
+
+        if(!logFileNameIsAbsolutePath){
+            // compose logFile path
+            char cwd[256];
+            getcwd(cwd, 256);
+
+            logFileDir = std::string(cwd) + dirSeparator + "log";
+            m_logFilePath = logFileDir + dirSeparator + logFileName;
+        }
+        else{
+            m_logFilePath = logFileName;
+            std::size_t found = logFileName.rfind(dirSeparator);
+            if(found != std::string::npos){
+                logFileDir = logFileName.substr(0, found);
+            }
+            else{
+                logFileDir = dirSeparator;
+            }
+        }
+
+        // check that no other logger is already writing to that file
+        if (std::find(s_openLogFiles.begin(), s_openLogFiles.end(), m_logFilePath) != s_openLogFiles.end()){
+            std::string errMsg = "-----------\nERROR: log-file (" + m_logFilePath + ") already in use by other Logger!\n-----------";
+            printToConsole(errMsg);
+        }
+        else{
+            s_openLogFiles.push_back(m_logFilePath);
+        }
+
+        // check if log directory exists and create it if not
+        if(!fs::exists(logFileDir)){
+            fs::create_directory(logFileDir);
+        }
+
+        if(m_logFilePath.substr(m_logFilePath.size()-4, 4) == ".log"){          // append mode
+            m_sink.open(m_logFilePath, true);
+        }
+        else if(m_logFilePath.size() > 5 && m_logFilePath.substr(m_logFilePath.size()-5, 5) == ".blog"){  // binary log, append mode
+            m_sink.open(m_logFilePath, true);
+        }
+        else if(m_logFilePath.size() > 5 && m_logFilePath.substr(m_logFilePath.size()-5, 5) == ".ccol"){  // binary columnar csv, delete file content
+            m_sink.open(m_logFilePath, false);
+        }
+        else if(m_logFilePath.substr(m_logFilePath.size()-4, 4) == ".csv"){     // delete file content and write afterwards
+            m_sink.open(m_logFilePath, false);
+        }
+        else{
+            std::string errMsg = "-----------\nERROR: Unknown log-file type!\n-----------";
+            printToConsole(errMsg);
+        }
+
+        // check if logfile creation and opening as been successful
+        if(!m_sink.isOpen()){
+            std::string errMsg = "-----------\nERROR: Could not open log-file! " + m_logFilePath + "\n-----------";
+            printToConsole(errMsg);
+        }
+        else{
+            std::string infoMsg = "Logging to file " + m_logFilePath;
+            printToConsole(infoMsg);
+        }
+    }
+
+    // handle printing to console with time stamps etc.
+    void printToConsole(const std::string& msg){
+
+        // console output takes locks, which might be held by the crashed thread
+        if(LogCrashRegistry::isCrashing()){
+            return;
+        }
+
+        #if ENABLE_MULTITHREADING
+        LogConsoleSink* consoleSink = m_consoleSink.load(std::memory_order_acquire);
+        if(consoleSink != nullptr){
+            consoleSink->write(msg);
+            return;
+        }
+        #endif
+
+        // note: I used to differentiate between error messages (then printed with cerr <<) and non-error messages (printed with cout <<)
+        // but as this might affect printing order (which was initially the objective of differentiating), I removed it
+        #if ENABLE_MULTITHREADING
+        consoleMutex.lock();
+        #endif
+        std::cout << msg << std::endl;
+        #if ENABLE_MULTITHREADING
+        consoleMutex.unlock();
+        #endif
+    }
+
+    // prints entry to logfile (buffered according to flush policy); timeNs goes to time index (0 -> time of writing)
+    void printToFile(const std::string& msg, LogLevel logLevel=LogLevel::Info, std::int64_t timeNs=0){
+
+        #ifdef __linux__
+        if(m_mappedSink){
+            m_mappedSink->write(msg);
+            return;
+        }
+        #endif
+
+        rotateFileIfDue();
+
+        // print to file
+        m_sink.write(msg, logLevel, timeNs);
+    }
+
+    // starts a new file if rotation policy says so
+    void rotateFileIfDue(){
+        if(m_sink.rotateIfDue()){
+            writeFileHeader();
+        }
+    }
+
+    // called after a new file has been started by rotation, before next entry is written
+    virtual void writeFileHeader(){}
+
+    // writes summary of messages suppressed by rate limiting (see setRateLimit)
+    virtual void reportSuppressed(const std::string& msg){ (void)msg; }
+
+    // hands entries the logger collects itself (e.g. rows of an unfinished chunk) to the sink; called before flush or sync
+    virtual void flushPending(){}
+
+    // writes entry taken from queue; barriers are passed to the sink, which satisfies them on next commit
+    void writeEntry(LogEntryPtr entry){
+        if(entry->isBarrier()){
+            // process is going down: callbacks can't be run from within a signal handler
+            if(LogCrashRegistry::isCrashing()){
+                entry.release();
+                return;
+            }
+            LogEntryBarrier& barrier = static_cast<LogEntryBarrier&>(*entry);
+            flushPending();
+            m_sink.addDurabilityRequest(barrier.isSync(), barrier.takeCallback());
+            return;
+        }
+        print(std::move(entry));
+    }
+
+    // writes everything buffered to file; called by LogCrashHandler (possibly from a signal handler), so
+    // overrides should not take locks
+    virtual void emergencyFlush(){
+        m_sink.emergencyFlush();
+    }
+
+    // prints msg to logfile as it is (no newline added)
+    void printRawToFile(std::string_view msg){
+        #ifdef __linux__
+        if(m_mappedSink){
+            m_mappedSink->writeRaw(msg);
+            return;
+        }
+        #endif
+        m_sink.writeRaw(msg);
+    }
+
+    #ifdef __linux__
+    std::unique_ptr<MappedLogSink> m_mappedSink;    // if set, used instead of m_sink
+    #endif
+
+private:
+
+    std::atomic<bool> m_isHandledByThreader;      // defines if logger should work on its own (false) or if logging is done by LogThreader in separate thread (true)
+
+    inline static std::size_t s_defaultQueueCapacity = 8192;    // capacity of queues (and entry pools) of new loggers
+
+    inline static std::vector<std::string> s_openLogFiles; // holds paths to all currently open log files in order to make sure that not two loggers are writing to same one
+
+    std::array<std::atomic<const LogRateLimit*>, 4> m_rateLimits{};    // per level; nullptr -> not limited
+    std::atomic<bool> m_hasRateLimits{false};
+    std::array<std::array<LogRateLimit, 2>, 4> m_rateLimitSlots{};     // storage of m_rateLimits (see setRateLimit)
+    std::mutex m_suppressingSitesMutex;
+    std::vector<std::pair<LogCallSite*, LogLevel>> m_suppressingSites;     // call sites which suppressed messages of this logger
+
+    // call sites are statics of LOG_<LEVEL> macros, so they stay valid as long as the logger
+    void watchCallSite(LogCallSite& site, LogLevel logLevel){
+        std::lock_guard<std::mutex> lock(m_suppressingSitesMutex);
+        for(const std::pair<LogCallSite*, LogLevel>& watched : m_suppressingSites){
+            if(watched.first == &site){
+                return;
+            }
+        }
+        m_suppressingSites.emplace_back(&site, logLevel);
+    }
+
+    // construct entry, give command to write to console and/or file
+    virtual void print(LogEntryPtr entry, bool enforceConsoleWriting=false) = 0;
+
+    #if ENABLE_MULTITHREADING
+    std::future<bool> requestDurability(bool sync){
+        std::shared_ptr<std::promise<bool>> promise = std::make_shared<std::promise<bool>>();
+        std::future<bool> future = promise->get_future();
+        requestDurability(sync, [promise](bool isOk){ promise->set_value(isOk); });
+        return future;
+    }
+    #endif
+
+    void requestDurability(bool sync, LogDurabilityCallback done){
+        reportPendingSuppressed(true);
+
+        #ifdef __linux__
+        // memory mapped entries are in the page cache as soon as they have been copied
+        if(m_mappedSink){
+            done(!sync || m_mappedSink->sync());
+            return;
+        }
+        #endif
+        #if ENABLE_MULTITHREADING
+        if(isHandledByThreader()){
+            enqueue(LogEntryPtr(new LogEntryBarrier(sync, std::move(done))));
+            return;
+        }
+        #endif
+        flushPending();
+        m_sink.addDurabilityRequest(sync, std::move(done));
+        m_sink.commit();
+        m_sink.settle();
+    }
+
+    // drains queues and buffers when process dies
+    friend class LogCrashHandler;
+
+    // writes entries of other processes (shared memory rings) with loggers of its own
+    friend class LogShmWriter;
+
+
+#if ENABLE_MULTITHREADING
+public:
+    // removes first item in queue and passes it to caller (e.g. LogThreader) (returns nullptr if queue empty)
+    // with thread buffers, the oldest entry of all threads is returned; only one thread at a time may call this then
+    LogEntryPtr getQueueItem(){
+
+        LogEntryPtr entry;
+        if(m_logEntries->pop(entry) || !m_useThreadBuffers.load(std::memory_order_acquire)){
+            return entry;
+        }
+
+        if(m_threadBuffersVersion.load(std::memory_order_acquire) != m_drainBuffersVersion){
+            std::lock_guard<std::mutex> lock(m_threadBuffersMutex);
+            m_drainBuffers = m_threadBuffers;
+            m_drainBuffersVersion = m_threadBuffersVersion.load(std::memory_order_relaxed);
+            m_mergeBuffer = nullptr;
+        }
+
+        // entries of the buffer found last time can be taken without looking at the others,
+        // as long as they are older than the oldest entry of all other buffers and than the last scan
+        if(m_mergeBuffer != nullptr){
+            LogThreadBuffer::Item* item = m_mergeBuffer->ring.front();
+            if(item != nullptr && item->timeNs <= m_mergeLimit){
+                entry = std::move(item->entry);
+                m_mergeBuffer->ring.popFront();
+                return entry;
+            }
+            m_mergeBuffer = nullptr;
+        }
+
+        // merge: take entry with oldest time stamp of all buffers
+        std::uint64_t scanTime = LogThreadBuffer::now();
+        LogThreadBuffer* oldest = nullptr;
+        LogThreadBuffer::Item* oldestItem = nullptr;
+        std::uint64_t secondOldest = UINT64_MAX;
+        bool hasRetired = false;
+        for(auto& buffer : m_drainBuffers){
+            LogThreadBuffer::Item* item = buffer->ring.front();
+            if(item == nullptr){
+                if(buffer->retired.load(std::memory_order_acquire)){
+                    hasRetired = true;
+                }
+                continue;
+            }
+            if(oldestItem == nullptr || item->timeNs < oldestItem->timeNs){
+                if(oldestItem != nullptr){
+                    secondOldest = oldestItem->timeNs;
+                }
+                oldest = buffer.get();
+                oldestItem = item;
+            }
+            else if(item->timeNs < secondOldest){
+                secondOldest = item->timeNs;
+            }
+        }
+
+        if(hasRetired){
+            removeRetiredBuffers();
+        }
+
+        if(oldestItem != nullptr){
+            entry = std::move(oldestItem->entry);
+            oldest->ring.popFront();
+
+            // entries other threads log from now on are newer than the scan, so only entries logged before it may be
+            // taken without scanning again (else a busy thread would keep the others from being drained at all)
+            m_mergeBuffer = oldest;
+            m_mergeLimit = std::min(secondOldest, scanTime);
+        }
+        return entry;
+    }
+
+    // approximate amount of entries waiting in queue
+    int getQueueSize(){
+        std::size_t size = m_logEntries->size();
+        if(m_useThreadBuffers.load(std::memory_order_acquire)){
+            std::lock_guard<std::mutex> lock(m_threadBuffersMutex);
+            for(auto& buffer : m_threadBuffers){
+                size += buffer->ring.size();
+            }
+        }
+        return (int)size;
+    }
+
+    // every producing thread gets its own queue (created on its first log call), which LogThreader merges in order of time
+    // avoids contention if many threads log into the same logger; has to be called before logger is added to LogThreader
+    // as only LogThreader removes entries from these queues, DropOldest and Overwrite behave like DropNewest
+    bool enableThreadBuffers(std::size_t capacityPerThread = 1024){
+        if(isHandledByThreader()){
+            return false;
+        }
+        m_threadBufferCapacity = capacityPerThread;
+        m_useThreadBuffers.store(true, std::memory_order_release);
+        return true;
+    }
+
+    // changes capacity of queue (rounded up to power of two)
+    // only possible as long as logger is not handled by LogThreader, else returns false
+    bool setQueueCapacity(std::size_t capacity){
+        if(isHandledByThreader()){
+            return false;
+        }
+        m_logEntries = std::make_unique<LogRing<LogEntryPtr>>(capacity, m_logEntries->getPolicy());
+        return true;
+    }
+
+    // defines what log() does if queue is full; can be changed at any time
+    void setQueueOverflowPolicy(QueueOverflowPolicy policy){
+        m_logEntries->setPolicy(policy);
+    }
+
+    // amount of entries which were not written because queue was full (DropNewest, DropOldest)
+    std::uint64_t getDroppedNewestCount() const { return m_logEntries->getDroppedNewest() + m_threadBufferDrops.load(std::memory_order_relaxed); }
+
+    // amount of queued entries which got evicted to make room for newer ones (DropOldest, Overwrite)
+    std::uint64_t getDroppedOldestCount() const { return m_logEntries->getDroppedOldest(); }
+
+    // console output is handed to LogConsoleSink (written in batches on a background thread, dropped if console is too slow)
+    // instead of being written by the calling thread; enable=false goes back to direct output
+    void enableAsyncConsole(bool enable=true, LogConsoleSink::Stream stream=LogConsoleSink::Stdout){
+        m_consoleSink.store(enable ? &LogConsoleSink::instance(stream) : nullptr, std::memory_order_release);
+    }
+
+    // additionally measures enqueue and end-to-end latency of every entry (costs two clock reads per log call)
+    void enableInstrumentation(bool enable=true){
+        if(enable && !m_enqueueLatency){
+            m_enqueueLatency = std::make_unique<AtomicLatencyHistogram>();
+            m_endToEndLatency = std::make_unique<AtomicLatencyHistogram>();
+        }
+        m_isInstrumented.store(enable, std::memory_order_release);
+    }
+
+    // may be called from any thread at any time
+    LoggerStats getStats(){
+        LoggerStats stats;
+        stats.written = m_writtenCount.load(std::memory_order_relaxed);
+        stats.droppedNewest = getDroppedNewestCount();
+        stats.droppedOldest = getDroppedOldestCount();
+        stats.queueDepth = (std::size_t)getQueueSize();
+        stats.queueHighWater = m_queueHighWater.load(std::memory_order_relaxed);
+        stats.enqueued = stats.written + stats.queueDepth + stats.droppedNewest + stats.droppedOldest;
+        if(m_isInstrumented.load(std::memory_order_acquire)){
+            stats.enqueueLatency = m_enqueueLatency->snapshot();
+            stats.endToEndLatency = m_endToEndLatency->snapshot();
+        }
+        stats.sink = m_sink.getStats();
+        return stats;
+    }
+
+protected:
+    // hands entry over to LogThreader
+    void enqueue(LogEntryPtr entry){
+        bool isInstrumented = m_isInstrumented.load(std::memory_order_acquire);
+        std::uint64_t startNs = 0;
+        if(isInstrumented){
+            startNs = LogThreadBuffer::now();
+            entry->setQueuedAt(startNs);
+        }
+
+        std::size_t queueSize;
+        if(m_useThreadBuffers.load(std::memory_order_relaxed)){
+            LogThreadBuffer& buffer = threadBuffer();
+            if(!pushToThreadBuffer(buffer, std::move(entry))){
+                return;
+            }
+            queueSize = buffer.ring.size();
+        }
+        else{
+            m_logEntries->push(std::move(entry));
+            queueSize = m_logEntries->size();
+        }
+
+        if(isInstrumented){
+            m_enqueueLatency->add(LogThreadBuffer::now() - startNs);
+        }
+
+        // shared cache line is only written if there is a new maximum
+        std::size_t highWater = m_queueHighWater.load(std::memory_order_relaxed);
+        while(queueSize > highWater && !m_queueHighWater.compare_exchange_weak(highWater, queueSize, std::memory_order_relaxed)){}
+
+        // below wake threshold LogThreader picks entry up after its maximal latency anyway
+        LogSignal* signal = m_signal.load(std::memory_order_acquire);
+        if(signal != nullptr && queueSize >= m_wakeThreshold.load(std::memory_order_relaxed)){
+            signal->notify();
+        }
+    }
+
+    std::atomic<LogSignal*> m_signal{nullptr};      // set by LogThreader; used to wake it up (signal of owning worker)
+    std::atomic<std::size_t> m_wakeThreshold{1};    // queue size from which on log calls wake LogThreader
+    std::atomic<std::size_t> m_worker{0};           // LogThreader worker this logger is assigned to
+    std::atomic<bool> m_draining{false};            // set while a worker writes entries, so only one at a time does
+
+    // if handled by LogThreader, log-method writes into this buffer instead of writing directly to file and/or console
+    std::unique_ptr<LogRing<LogEntryPtr>> m_logEntries;
+
+    // called by LogThreader after an entry of the queue has been written (only one thread at a time)
+    void countWritten(std::uint64_t queuedAtNs){
+        m_writtenCount.store(m_writtenCount.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        if(queuedAtNs != 0 && m_isInstrumented.load(std::memory_order_relaxed)){
+            m_endToEndLatency->add(LogThreadBuffer::now() - queuedAtNs);
+        }
+    }
+
+    std::atomic<std::uint64_t> m_writtenCount{0};
+    std::atomic<std::size_t> m_queueHighWater{0};
+    std::atomic<bool> m_isInstrumented{false};
+    std::atomic<LogConsoleSink*> m_consoleSink{nullptr};           // if set, console output goes through it
+    std::unique_ptr<AtomicLatencyHistogram> m_enqueueLatency;       // created when instrumentation is enabled first
+    std::unique_ptr<AtomicLatencyHistogram> m_endToEndLatency;
+
+private:
+    // buffer of calling thread for this logger, registered on first use
+    LogThreadBuffer& threadBuffer(){
+        thread_local LogThreadBufferRegistry registry;
+        for(auto& buffer : registry.buffers){
+            if(buffer.first == m_loggerId){
+                return *buffer.second;
+            }
+        }
+
+        registry.prune();
+        std::shared_ptr<LogThreadBuffer> buffer = std::make_shared<LogThreadBuffer>(m_threadBufferCapacity);
+        {
+            std::lock_guard<std::mutex> lock(m_threadBuffersMutex);
+            m_threadBuffers.push_back(buffer);
+            m_threadBuffersVersion.fetch_add(1, std::memory_order_release);
+        }
+        registry.buffers.emplace_back(m_loggerId, buffer);
+        return *buffer;
+    }
+
+    bool pushToThreadBuffer(LogThreadBuffer& buffer, LogEntryPtr entry){
+        LogThreadBuffer::Item item{LogThreadBuffer::now(), std::move(entry)};
+        if(buffer.ring.tryPush(item)){
+            return true;
+        }
+
+        if(m_logEntries->getPolicy() == QueueOverflowPolicy::Block){
+            while(!buffer.ring.tryPush(item)){
+                std::this_thread::yield();
+            }
+            return true;
+        }
+
+        m_threadBufferDrops.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    // called by consumer: forgets buffers of exited threads which have been drained completely
+    void removeRetiredBuffers(){
+        std::lock_guard<std::mutex> lock(m_threadBuffersMutex);
+        std::size_t nBuffers = m_threadBuffers.size();
+        m_threadBuffers.erase(std::remove_if(m_threadBuffers.begin(), m_threadBuffers.end(), [](const std::shared_ptr<LogThreadBuffer>& buffer){
+            return buffer->retired.load(std::memory_order_acquire) && buffer->ring.empty();
+        }), m_threadBuffers.end());
+
+        if(m_threadBuffers.size() != nBuffers){
+            m_drainBuffers = m_threadBuffers;
+            m_mergeBuffer = nullptr;
+            m_drainBuffersVersion = m_threadBuffersVersion.fetch_add(1, std::memory_order_release) + 1;
+        }
+    }
+
+    inline static std::atomic<std::uint64_t> s_nextLoggerId{1};
+    const std::uint64_t m_loggerId = s_nextLoggerId.fetch_add(1, std::memory_order_relaxed);    // key of thread buffers
+
+    std::atomic<bool> m_useThreadBuffers{false};
+    std::size_t m_threadBufferCapacity = 1024;
+    std::atomic<std::uint64_t> m_threadBufferDrops{0};
+
+    std::mutex m_threadBuffersMutex;                                // guards m_threadBuffers
+    std::vector<std::shared_ptr<LogThreadBuffer>> m_threadBuffers;  // buffers of all threads which logged so far
+    std::atomic<unsigned int> m_threadBuffersVersion{0};
+
+    std::vector<std::shared_ptr<LogThreadBuffer>> m_drainBuffers;   // consumer's copy of m_threadBuffers
+    unsigned int m_drainBuffersVersion = 0;
+    LogThreadBuffer* m_mergeBuffer = nullptr;                       // buffer which had the oldest entry at last scan
+    std::uint64_t m_mergeLimit = 0;                                 // oldest entry of all other buffers at last scan
+
+    // LogThreader needs to access print function
+    friend class LogThreader;
+
+#endif
+
+};
+
+/* Format strings in the style of std::format ("value {} of {:.3f}"), checked at compile time
+ * supported replacement fields: {} or {:spec} with spec = [0][width][.precision][type]
+ *   integers: type d, x, X, b    floating point: type f, e, g    others: width only
+ * "{{" and "}}" are written as single braces; fields are taken in order (no argument indices)
+ * own implementation, as <format> isn't available with all compilers this logger is used with */
+struct LogFormatSpec{
+    bool zeroPad = false;
+    std::size_t width = 0;
+    int precision = -1;
+    char type = '\0';
+
+    // returns false if spec is malformed (also called at compile time)
+    static constexpr bool parse(std::string_view spec, LogFormatSpec& out){
+        std::size_t i = 0;
+        if(i < spec.size() && spec[i] == '0'){
+            out.zeroPad = true;
+            ++i;
+        }
+        while(i < spec.size() && spec[i] >= '0' && spec[i] <= '9'){
+            out.width = out.width * 10 + (std::size_t)(spec[i++] - '0');
+        }
+        if(i < spec.size() && spec[i] == '.'){
+            ++i;
+            if(i == spec.size() || spec[i] < '0' || spec[i] > '9'){
+                return false;
+            }
+            out.precision = 0;
+            while(i < spec.size() && spec[i] >= '0' && spec[i] <= '9'){
+                out.precision = out.precision * 10 + (spec[i++] - '0');
+            }
+        }
+        if(i < spec.size()){
+            out.type = spec[i++];
+        }
+        return i == spec.size() && out.width <= 256 && out.precision <= 64;
+    }
+
+    // checks spec against allowed types; numbers may use zero padding and (floats only) precision
+    static constexpr bool check(std::string_view spec, std::string_view types, bool isNumber, bool hasPrecision){
+        LogFormatSpec parsed;
+        if(!parse(spec, parsed)){
+            return false;
+        }
+        if((parsed.zeroPad && !isNumber) || (parsed.precision >= 0 && !hasPrecision)){
+            return false;
+        }
+        return parsed.type == '\0' || types.find(parsed.type) != std::string_view::npos;
+    }
+
+    // writes str, padded to width (numbers are aligned right, everything else left)
+    void pad(std::string& out, std::string_view str, bool alignRight) const {
+        std::size_t fill = width > str.size() ? width - str.size() : 0;
+        if(alignRight && zeroPad && fill > 0 && !str.empty() && (str[0] == '-' || str[0] == '+')){
+            out.push_back(str[0]);
+            str.remove_prefix(1);
+        }
+        if(alignRight) out.append(fill, zeroPad ? '0' : ' ');
+        out += str;
+        if(!alignRight) out.append(fill, ' ');
+    }
+};
+
+// customization point: specialize for own types, e.g.
+//   template<> struct LogFormatter<Vec3>{
+//       static constexpr bool checkSpec(std::string_view spec){ return spec.empty(); }
+//       static void format(std::string& out, const Vec3& v, std::string_view spec){ ... append to out ... }
+//   };
+template<typename T, typename Enable = void>
+struct LogFormatter;
+
+template<typename T>
+struct LogFormatter<T, std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool> && !std::is_same_v<T, char>>>{
+    static constexpr bool checkSpec(std::string_view spec){
+        return LogFormatSpec::check(spec, "dxXb", true, false);
+    }
+    static void format(std::string& out, T value, std::string_view spec){
+        char buffer[80];
+        if(spec.empty()){
+            std::to_chars_result result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+            out.append(buffer, result.ptr - buffer);
+            return;
+        }
+        LogFormatSpec parsed;
+        LogFormatSpec::parse(spec, parsed);
+        int base = parsed.type == 'x' || parsed.type == 'X' ? 16 : parsed.type == 'b' ? 2 : 10;
+        std::to_chars_result result = std::to_chars(buffer, buffer + sizeof(buffer), value, base);
+        if(parsed.type == 'X'){
+            for(char* c = buffer; c != result.ptr; ++c) *c = (char)std::toupper((unsigned char)*c);
+        }
+        parsed.pad(out, std::string_view(buffer, result.ptr - buffer), true);
+    }
+};
+
+template<typename T>
+struct LogFormatter<T, std::enable_if_t<std::is_floating_point_v<T>>>{
+    static constexpr bool checkSpec(std::string_view spec){
+        return LogFormatSpec::check(spec, "feg", true, true);
+    }
+    static void format(std::string& out, T value, std::string_view spec){
+        char buffer[128];
+        std::to_chars_result result;
+        if(spec.empty()){
+            // shortest representation which reads back to the same value
+            result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+            out.append(buffer, result.ptr - buffer);
+            return;
+        }
+        LogFormatSpec parsed;
+        LogFormatSpec::parse(spec, parsed);
+        std::chars_format charsFormat = parsed.type == 'f' ? std::chars_format::fixed
+                                      : parsed.type == 'e' ? std::chars_format::scientific
+                                      : std::chars_format::general;
+        if(parsed.precision >= 0){
+            result = std::to_chars(buffer, buffer + sizeof(buffer), value, charsFormat, parsed.precision);
+        }
+        else if(parsed.type != '\0'){
+            result = std::to_chars(buffer, buffer + sizeof(buffer), value, charsFormat);
+        }
+        else{
+            result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+        }
+        if(result.ec != std::errc()){
+            out += "<overflow>";    // e.g. fixed notation of huge values
+            return;
+        }
+        parsed.pad(out, std::string_view(buffer, result.ptr - buffer), true);
+    }
+};
+
+template<>
+struct LogFormatter<bool>{
+    static constexpr bool checkSpec(std::string_view spec){
+        return LogFormatSpec::check(spec, "", false, false);
+    }
+    static void format(std::string& out, bool value, std::string_view spec){
+        LogFormatSpec parsed;
+        LogFormatSpec::parse(spec, parsed);
+        parsed.pad(out, value ? "true" : "false", false);
+    }
+};
+
+template<>
+struct LogFormatter<char>{
+    static constexpr bool checkSpec(std::string_view spec){
+        return LogFormatSpec::check(spec, "", false, false);
+    }
+    static void format(std::string& out, char value, std::string_view spec){
+        LogFormatSpec parsed;
+        LogFormatSpec::parse(spec, parsed);
+        parsed.pad(out, std::string_view(&value, 1), false);
+    }
+};
+
+// std::string, std::string_view, string literals and char pointers
+template<typename T>
+struct LogFormatter<T, std::enable_if_t<std::is_convertible_v<const T&, std::string_view>>>{
+    static constexpr bool checkSpec(std::string_view spec){
+        return LogFormatSpec::check(spec, "s", false, false);
+    }
+    static void format(std::string& out, const T& value, std::string_view spec){
+        if constexpr (std::is_pointer_v<std::decay_t<T>>){
+            if(value == nullptr){
+                out += "(null)";
+                return;
+            }
+        }
+        if(spec.empty()){
+            out += std::string_view(value);
+            return;
+        }
+        LogFormatSpec parsed;
+        LogFormatSpec::parse(spec, parsed);
+        parsed.pad(out, std::string_view(value), false);
+    }
+};
+
+// other pointers are written as address
+template<typename T>
+struct LogFormatter<T*, std::enable_if_t<!std::is_convertible_v<T* const&, std::string_view>>>{
+    static constexpr bool checkSpec(std::string_view spec){
+        return LogFormatSpec::check(spec, "p", false, false);
+    }
+    static void format(std::string& out, const T* value, std::string_view spec){
+        char buffer[2 + 2 * sizeof(void*)] = {'0', 'x'};
+        std::to_chars_result result = std::to_chars(buffer + 2, buffer + sizeof(buffer), (std::uintptr_t)value, 16);
+        LogFormatSpec parsed;
+        LogFormatSpec::parse(spec, parsed);
+        parsed.pad(out, std::string_view(buffer, result.ptr - buffer), true);
+    }
+};
+
+namespace LogFormatError{
+    // not constexpr on purpose: reaching one of these while checking a format string at compile time
+    // stops compilation, and the name of the function tells what is wrong
+    inline void tooFewArguments(){}
+    inline void tooManyArguments(){}
+    inline void unmatchedBrace(){}
+    inline void invalidSpec(){}
+}
+
+/* Format string which gets checked against the types of the arguments at compile time
+ * only string literals are accepted; runtime strings have to be logged as message (log(msg, level))
+ * a literal without fields followed by a single string is a message with custom time string (log<Level>(msg, timeStr)) */
+template<typename... Args>
+class LogFormatString{
+public:
+    template<std::size_t N>
+    consteval LogFormatString(const char (&fmt)[N])
+        :m_fmt(fmt, N - 1)
+    {
+        check();
+    }
+
+    constexpr std::string_view get() const { return m_fmt; }
+
+    // false: literal is a plain message and the only argument its custom time string
+    constexpr bool hasFields() const { return m_hasFields; }
+
+private:
+    consteval void check(){
+        constexpr std::size_t nArgs = sizeof...(Args);
+        std::size_t nFields = 0;
+
+        for(std::size_t i = 0; i < m_fmt.size(); ++i){
+            if(m_fmt[i] == '}'){
+                if(i + 1 < m_fmt.size() && m_fmt[i + 1] == '}'){
+                    ++i;
+                    continue;
+                }
+                LogFormatError::unmatchedBrace();
+            }
+            if(m_fmt[i] != '{'){
+                continue;
+            }
+            if(i + 1 < m_fmt.size() && m_fmt[i + 1] == '{'){
+                ++i;
+                continue;
+            }
+            std::size_t end = m_fmt.find('}', i);
+            if(end == std::string_view::npos){
+                LogFormatError::unmatchedBrace();
+            }
+            std::string_view field = m_fmt.substr(i + 1, end - i - 1);
+            if(!field.empty() && field[0] != ':'){
+                LogFormatError::invalidSpec();      // no argument indices or names
+            }
+            if(nFields >= nArgs){
+                LogFormatError::tooFewArguments();
+            }
+            if(!checkSpec(nFields, field.empty() ? field : field.substr(1))){
+                LogFormatError::invalidSpec();
+            }
+            ++nFields;
+            i = end;
+        }
+        if(nFields == 0 && nArgs == 1 && (std::is_convertible_v<const Args&, std::string_view> && ...)){
+            m_hasFields = false;
+        }
+        else if(nFields < nArgs){
+            LogFormatError::tooManyArguments();
+        }
+    }
+
+    // spec of field index against type of argument index
+    static consteval bool checkSpec(std::size_t index, std::string_view spec){
+        if constexpr (sizeof...(Args) == 0){
+            return false;
+        }
+        else{
+            constexpr bool (*checks[])(std::string_view) = {&LogFormatter<Args>::checkSpec...};
+            return checks[index](spec);
+        }
+    }
+
+    std::string_view m_fmt;
+    bool m_hasFields = true;
+};
+
+// type whose LogFormatter is used for an argument (arrays become pointers, e.g. string literals -> const char*)
+template<typename T>
+using LogFormatType = std::decay_t<const T&>;
+
+// format string for given argument types; arguments are not used for deduction of the format string itself
+template<typename... Args>
+using LogFormatStringFor = LogFormatString<LogFormatType<Args>...>;
+
+struct LogFormat{
+    // appends formatted text to out; format string must have been checked (see LogFormatString)
+    // only out grows, so formatting into a reused string doesn't allocate once it has enough capacity
+    template<typename... Args>
+    static void format(std::string& out, std::string_view fmt, const Args&... args){
+        std::size_t pos = 0;
+        (formatField(out, fmt, pos, args), ...);
+        appendLiteral(out, fmt, pos, fmt.size());
+    }
+
+private:
+    // writes text up to next replacement field, then the argument
+    template<typename T>
+    static void formatField(std::string& out, std::string_view fmt, std::size_t& pos, const T& value){
+        std::size_t begin = pos;
+        while(pos < fmt.size()){
+            if(fmt[pos] == '{' && (pos + 1 >= fmt.size() || fmt[pos + 1] != '{')){
+                break;
+            }
+            pos += (fmt[pos] == '{' || fmt[pos] == '}') ? 2 : 1;
+        }
+        appendLiteral(out, fmt, begin, pos);
+        std::size_t end = fmt.find('}', pos);
+        std::string_view spec = end - pos > 1 ? fmt.substr(pos + 2, end - pos - 2) : std::string_view();
+        LogFormatter<LogFormatType<T>>::format(out, value, spec);
+        pos = end + 1;
+    }
+
+    // copies fmt[begin, end) and collapses escaped braces
+    static void appendLiteral(std::string& out, std::string_view fmt, std::size_t begin, std::size_t end){
+        while(begin < end){
+            std::size_t brace = fmt.find_first_of("{}", begin);
+            if(brace == std::string_view::npos || brace >= end){
+                out.append(fmt.data() + begin, end - begin);
+                return;
+            }
+            out.append(fmt.data() + begin, brace + 1 - begin);
+            begin = brace + 2;
+        }
+    }
+};
+
+/* Field names of one log statement (static at call site, see LOG_FIELDS), so names are processed only once:
+ * their escaped forms for all layouts are prepared in the constructor */
+class LogFieldKeys{
+public:
+    std::size_t size() const { return m_names.size(); }
+    const std::string& name(std::size_t i) const { return m_names[i]; }
+    const std::string& jsonKey(std::size_t i) const { return m_jsonKeys[i]; }        // ,"name":
+    const std::string& logfmtKey(std::size_t i) const { return m_logfmtKeys[i]; }    // " name="
+
+protected:
+    void add(std::string_view name);
+
+    std::vector<std::string> m_names;
+    std::vector<std::string> m_jsonKeys;
+    std::vector<std::string> m_logfmtKeys;
+};
+
+// amount of names is part of the type, so that it can be checked against the values at compile time
+template<std::size_t N>
+class LogKeys : public LogFieldKeys{
+public:
+    template<typename... Names>
+    LogKeys(const Names&... names){
+        static_assert(sizeof...(Names) == N, "amount of names does not match");
+        (add(std::string_view(names)), ...);
+    }
+};
+
+template<typename... Names>
+LogKeys(const Names&...) -> LogKeys<sizeof...(Names)>;
+
+/* Typed fields of structured entries, encoded one after another into a byte buffer:
+ * type tag (1 byte), then 8 bytes for numbers, 1 byte for bools, length (4 bytes) and bytes for strings
+ * rendering happens on the thread writing the entry (LogThreader for threaded loggers) */
+struct LogFields{
+    enum Type : std::uint8_t{
+        Int,
+        UInt,
+        Double,
+        Bool,
+        String
+    };
+
+    template<typename T>
+    static void encode(std::string& out, const T& value){
+        using D = std::decay_t<T>;
+        if constexpr (std::is_same_v<D, bool>){
+            out.push_back((char)Bool);
+            out.push_back(value ? 1 : 0);
+        }
+        else if constexpr (std::is_integral_v<D> && std::is_signed_v<D>){
+            encodePod(out, Int, (std::int64_t)value);
+        }
+        else if constexpr (std::is_integral_v<D>){
+            encodePod(out, UInt, (std::uint64_t)value);
+        }
+        else if constexpr (std::is_floating_point_v<D>){
+            encodePod(out, Double, (double)value);
+        }
+        else if constexpr (std::is_convertible_v<const T&, std::string_view>){
+            std::string_view str(value);
+            std::uint32_t len = (std::uint32_t)std::min<std::size_t>(str.size(), UINT32_MAX);
+            encodePod(out, String, len);
+            out.append(str.data(), len);
+        }
+        else{
+            static_assert(std::is_arithmetic_v<D>, "field type not supported (int, double, bool or string)");
+        }
+    }
+
+    // appends all fields of buffer in given layout (names taken from keys)
+    static void render(std::string& out, LogLayout layout, const LogFieldKeys& keys, std::string_view fields){
+        std::size_t pos = 0;
+        for(std::size_t i = 0; i < keys.size() && pos < fields.size(); ++i){
+            out += layout == LogLayout::JsonLines ? keys.jsonKey(i) : keys.logfmtKey(i);
+
+            Type type = (Type)fields[pos++];
+            switch(type){
+            case Int:
+                appendNumber(out, decodePod<std::int64_t>(fields, pos));
+                break;
+            case UInt:
+                appendNumber(out, decodePod<std::uint64_t>(fields, pos));
+                break;
+            case Double:
+                appendDouble(out, decodePod<double>(fields, pos), layout);
+                break;
+            case Bool:
+                out += fields[pos++] ? "true" : "false";
+                break;
+            case String:{
+                std::uint32_t len = decodePod<std::uint32_t>(fields, pos);
+                std::string_view str = fields.substr(pos, len);
+                pos += len;
+                if(layout == LogLayout::JsonLines) appendJsonString(out, str);
+                else appendLogfmtString(out, str);
+                break;
+            }
+            }
+        }
+    }
+
+    // start of entry for json lines and logfmt: time, level and message ({ is left open for json)
+    // custom time " " means no time (as in text layout)
+    static void appendHeader(std::string& out, LogLayout layout, LogLevel logLevel, std::string_view customTimeStr, std::int64_t timeNs, const LogTimeFormatter* timeFormatter, std::string_view msg){
+        bool isJson = layout == LogLayout::JsonLines;
+        if(isJson){
+            out.push_back('{');
+        }
+        if(customTimeStr != " "){
+            out += isJson ? "\"time\":" : "time=";
+
+            // time is formatted into out first and quoted afterwards if needed, so that no temporary string is needed
+            // (time strings don't need escaping: strftime output or custom time)
+            std::size_t timePos = out.size();
+            if(customTimeStr.empty()){
+                timeFormatter->append(out, timeNs);
+            }
+            else{
+                out += customTimeStr;
+            }
+            if(isJson || std::string_view(out).substr(timePos).find_first_of(" \"=\\") != std::string_view::npos){
+                out.insert(timePos, 1, '"');
+                out.push_back('"');
+            }
+            out.push_back(isJson ? ',' : ' ');
+        }
+
+        out += isJson ? "\"level\":\"" : "level=";
+        out += levelName(logLevel);
+        out += isJson ? "\",\"msg\":" : " msg=";
+        if(isJson) appendJsonString(out, msg);
+        else appendLogfmtString(out, msg);
+    }
+
+    static const char* levelName(LogLevel logLevel){
+        switch(logLevel){
+        case LogLevel::Error:   return "error";
+        case LogLevel::Warning: return "warning";
+        case LogLevel::Info:    return "info";
+        case LogLevel::Debug:   return "debug";
+        }
+        return "undefined";
+    }
+
+    static void appendJsonString(std::string& out, std::string_view str){
+        static const char* hex = "0123456789abcdef";
+        out.push_back('"');
+        std::size_t begin = 0;
+        for(std::size_t i = 0; i < str.size(); ++i){
+            unsigned char c = (unsigned char)str[i];
+            if(c >= 0x20 && c != '"' && c != '\\'){
+                continue;
+            }
+            out.append(str.data() + begin, i - begin);
+            begin = i + 1;
+            switch(c){
+            case '"':  out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n";  break;
+            case '\r': out += "\\r";  break;
+            case '\t': out += "\\t";  break;
+            default:
+                out += "\\u00";
+                out.push_back(hex[c >> 4]);
+                out.push_back(hex[c & 0xF]);
+            }
+        }
+        out.append(str.data() + begin, str.size() - begin);
+        out.push_back('"');
+    }
+
+    // bare if possible, else quoted with escaped quotes, backslashes and line breaks
+    static void appendLogfmtString(std::string& out, std::string_view str){
+        bool needsQuotes = str.empty();
+        for(char c : str){
+            if((unsigned char)c <= ' ' || c == '"' || c == '=' || c == '\\'){
+                needsQuotes = true;
+                break;
+            }
+        }
+        if(!needsQuotes){
+            out += str;
+            return;
+        }
+        out.push_back('"');
+        for(char c : str){
+            switch(c){
+            case '"':  out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n";  break;
+            case '\r': out += "\\r";  break;
+            case '\t': out += "\\t";  break;
+            default:   out.push_back(c);
+            }
+        }
+        out.push_back('"');
+    }
+
+private:
+    template<typename T>
+    static void encodePod(std::string& out, Type type, T value){
+        out.push_back((char)type);
+        out.append((const char*)&value, sizeof(T));
+    }
+
+    template<typename T>
+    static T decodePod(std::string_view fields, std::size_t& pos){
+        T value;
+        std::memcpy(&value, fields.data() + pos, sizeof(T));
+        pos += sizeof(T);
+        return value;
+    }
+
+    template<typename T>
+    static void appendNumber(std::string& out, T value){
+        char buffer[32];
+        std::to_chars_result result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+        out.append(buffer, result.ptr - buffer);
+    }
+
+    // json has no representation of nan and infinity
+    static void appendDouble(std::string& out, double value, LogLayout layout){
+        if(layout == LogLayout::JsonLines && !std::isfinite(value)){
+            out += "null";
+            return;
+        }
+        appendNumber(out, value);
+    }
+};
+
+inline void LogFieldKeys::add(std::string_view name){
+    m_names.emplace_back(name);
+
+    std::string jsonKey = ",";
+    LogFields::appendJsonString(jsonKey, name);
+    jsonKey += ":";
+    m_jsonKeys.push_back(jsonKey);
+
+    // logfmt keys can't be quoted, so characters which would break the line are replaced
+    std::string logfmtKey = " ";
+    for(char c : name){
+        logfmtKey.push_back((unsigned char)c <= ' ' || c == '"' || c == '=' ? '_' : c);
+    }
+    logfmtKey += "=";
+    m_logfmtKeys.push_back(logfmtKey);
+}
+
+/* Derived Logger class to represend log-entries in normal text log */
+class LogEntryText : public LogEntry{
+public:
+    LogEntryText(LogLevel logLevel,
+                 std::string_view msg,
+                 std::string_view customTimeStr = "",
+                 std::int64_t timeNs = 0,
+                 const LogTimeFormatter* timeFormatter = nullptr)
+    {
+        assign(logLevel, msg, customTimeStr, timeNs, timeFormatter);
+    }
+
+    // re-initializes entry (used by LogEntryPool); keeps capacity of strings, so no allocation is needed
+    void assign(LogLevel logLevel,
+                std::string_view msg,
+                std::string_view customTimeStr = "",
+                std::int64_t timeNs = 0,
+                const LogTimeFormatter* timeFormatter = nullptr)
+    {
+        m_logLevel = logLevel;
+        m_msg.assign(msg.data(), msg.size());
+        m_customTimeStr.assign(customTimeStr.data(), customTimeStr.size());
+        m_timeNs = timeNs;
+        m_timeFormatter = timeFormatter != nullptr ? timeFormatter : &defaultTimeFormatter();
+    }
+    
+    LogLevel getLogLevel() const override { return m_logLevel; }
+
+    // time stamp as set by constructEntry (0 if only a custom time string is given)
+    std::int64_t getTimeNs() const override { return m_timeNs; }
+
+    // message buffer, so that it can be formatted in place (see TextLogger::log<Level>(fmt, args...))
+    std::string& message(){ return m_msg; }
+
+    void setLayout(LogLayout layout) override{ m_layout = layout; }
+
+    void constructEntry() override{
+        compose(nullptr, std::string_view());
+    }
+
+    // appends time and log level as written in front of every message ("<time> - <LEVEL>:   ")
+    // also used by other entry types and decoders so that all text logs share the same layout
+    static void addPrefix(std::string& out, LogLevel logLevel, std::string_view customTimeStr, std::int64_t timeNs, const LogTimeFormatter* timeFormatter){
+        addTime(out, customTimeStr, timeNs, timeFormatter);
+        addLogLevel(out, logLevel);
+    }
+
+protected:
+    // everything gets written in place, one after another
+    void compose(const LogFieldKeys* keys, std::string_view fields){
+        m_entry.clear();
+        if(m_timeNs == 0 && m_customTimeStr.empty()){
+            m_timeNs = LogTimeFormatter::nowNs();
+        }
+
+        if(m_layout == LogLayout::Text){
+            addPrefix(m_entry, m_logLevel, m_customTimeStr, m_timeNs, m_timeFormatter);
+            m_entry += m_msg;
+        }
+        else{
+            LogFields::appendHeader(m_entry, m_layout, m_logLevel, m_customTimeStr, m_timeNs, m_timeFormatter, m_msg);
+        }
+
+        if(keys != nullptr){
+            LogFields::render(m_entry, m_layout, *keys, fields);
+        }
+        if(m_layout == LogLayout::JsonLines){
+            m_entry.push_back('}');
+        }
+    }
+
+private:
+    // adds log Level as string
+    static void addLogLevel(std::string& out, LogLevel logLevel){
+
+        // all log entries should have (nearly) same length, so level is filled up with spaces
+        // TODO does not work properly for Warnings (padding kept as it always was, so that layout of existing files doesn't change)
+        switch(logLevel){
+        case LogLevel::Error:   out += "ERROR:   ";     return;
+        case LogLevel::Warning: out += "WARNING:  ";    return;
+        case LogLevel::Info:    out += "INFO:    ";     return;
+        case LogLevel::Debug:   out += "DEBUG:   ";     return;
+        }
+        out += "UNDEFINED: ";
+    }
+
+    // adds time as string
+    static void addTime(std::string& out, std::string_view customTimeStr, std::int64_t timeNs, const LogTimeFormatter* timeFormatter){
+
+        // custom time
+        if(customTimeStr != ""){
+            // TODO format
+            if(customTimeStr != " "){
+                out += customTimeStr;
+                out += " - ";
+            }
+        }
+        else{
+            // real time
+            timeFormatter->append(out, timeNs);
+            out += " - ";
+        }
+    }
+
+    LogLevel m_logLevel;
+    std::string m_msg;
+    std::string m_customTimeStr = "";
+    std::int64_t m_timeNs = 0;                  // nanoseconds since epoch (0 -> time of constructEntry)
+    const LogTimeFormatter* m_timeFormatter;    // owned by logger (or default)
+    LogLayout m_layout = LogLayout::Text;       // set by logger right before constructEntry
+};
+
+/* Text entry with typed fields (see LogFields); values are encoded at log call and rendered in constructEntry */
+class LogEntryStructured : public LogEntryText{
+public:
+    template<typename... Values>
+    LogEntryStructured(LogLevel logLevel, std::string_view msg, std::int64_t timeNs, const LogTimeFormatter* timeFormatter, const LogFieldKeys* keys, const Values&... values)
+        :LogEntryText(logLevel, msg, "", timeNs, timeFormatter)
+    {
+        assignFields(keys, values...);
+    }
+
+    // re-initializes entry (used by LogEntryPool)
+    template<typename... Values>
+    void assign(LogLevel logLevel, std::string_view msg, std::int64_t timeNs, const LogTimeFormatter* timeFormatter, const LogFieldKeys* keys, const Values&... values){
+        LogEntryText::assign(logLevel, msg, "", timeNs, timeFormatter);
+        assignFields(keys, values...);
+    }
+
+    void constructEntry() override{
+        compose(m_keys, m_fields);
+    }
+
+private:
+    template<typename... Values>
+    void assignFields(const LogFieldKeys* keys, const Values&... values){
+        m_keys = keys;
+        m_fields.clear();
+        (LogFields::encode(m_fields, values), ...);
+    }
+
+    const LogFieldKeys* m_keys = nullptr;   // static at call site
+    std::string m_fields;
+};
+
+
+/* Registry of static format strings used by deferred logging (see LOG_DEFERRED)
+ * every call site registers its format string once and afterwards only passes the id */
+class LogFormatRegistry{
+public:
+    static constexpr std::uint32_t s_capacity = 16384;
+
+    // registers format string (has to have static storage duration, e.g. a string literal) and returns its id
+    static std::uint32_t add(const char* fmt){
+        std::uint32_t id = s_count.fetch_add(1, std::memory_order_relaxed);
+        if(id >= s_capacity){
+            return 0;       // id 0 is reserved as fallback
+        }
+        s_formats[id].store(fmt, std::memory_order_release);
+        return id;
+    }
+
+    static const char* get(std::uint32_t id){
+        if(id == 0 || id >= s_capacity){
+            return "<format registry full>";
+        }
+        const char* fmt = s_formats[id].load(std::memory_order_acquire);
+        return fmt != nullptr ? fmt : "<unknown format>";
+    }
+
+private:
+    inline static std::atomic<const char*> s_formats[s_capacity] = {};
+    inline static std::atomic<std::uint32_t> s_count{1};
+};
+
+/* Compact binary representation of deferred log entries
+ * record: header (type, level, payload length, format id, time) followed by the raw arguments, each prefixed by a type tag
+ * binary log files (.blog) consist of such records; format strings get written once per session as definition records
+ * all values are stored in native byte order */
+class LogRecordCodec{
+public:
+    enum RecordType : std::uint8_t {
+        Entry = 1,          // log entry: header + arguments
+        FormatDef = 2,      // format string definition: header (fmtId, payload = string)
+        SessionStart = 3,   // logger has been (re)started; invalidates all previous format definitions
+        SessionEnd = 4      // logger has been shut down
+    };
+
+    enum ArgTag : std::uint8_t {
+        Int32 = 1,
+        Int64 = 2,
+        UInt32 = 3,
+        UInt64 = 4,
+        Double = 5,
+        String = 6,         // u16 length + bytes
+        Char = 7,
+        Bool = 8,
+        Pointer = 9
+    };
+
+    struct Header{
+        std::uint8_t type;
+        std::uint8_t level;
+        std::uint16_t payloadLen;
+        std::uint32_t fmtId;
+        std::int64_t timeNs;
+    };
+    static_assert(sizeof(Header) == 16, "unexpected padding in record header");
+
+    static constexpr char s_magic[8] = {'B', 'L', 'O', 'G', '0', '0', '0', '1'};
+
+    // writes header with payloadLen 0 (gets patched by finishRecord)
+    static void beginRecord(std::string& out, RecordType type, LogLevel level, std::uint32_t fmtId, std::int64_t timeNs){
+        Header header{(std::uint8_t)type, (std::uint8_t)level, 0, fmtId, timeNs};
+        out.append((const char*)&header, sizeof(header));
+    }
+
+    static constexpr std::size_t s_maxPayload = 0xFFFF;
+
+    // sets payload length in header of record starting at out[0]; longer payloads get cut, so that the record is
+    // exactly as long as its header says (arguments cut off are printed as "<?>" by expand)
+    static void finishRecord(std::string& out){
+        if(out.size() - sizeof(Header) > s_maxPayload){
+            out.resize(sizeof(Header) + s_maxPayload);
+        }
+        std::uint16_t len = (std::uint16_t)(out.size() - sizeof(Header));
+        std::memcpy(&out[offsetof(Header, payloadLen)], &len, sizeof(len));
+    }
+
+    template<typename T>
+    static void appendArg(std::string& out, const T& value){
+        using D = std::decay_t<T>;
+        if constexpr (std::is_same_v<D, bool>){
+            appendTagged(out, Bool, (std::uint8_t)value);
+        }
+        else if constexpr (std::is_same_v<D, char>){
+            appendTagged(out, Char, value);
+        }
+        else if constexpr (std::is_enum_v<D>){
+            appendArg(out, (std::underlying_type_t<D>)value);
+        }
+        else if constexpr (std::is_integral_v<D> && std::is_signed_v<D>){
+            if constexpr (sizeof(D) <= 4) appendTagged(out, Int32, (std::int32_t)value);
+            else appendTagged(out, Int64, (std::int64_t)value);
+        }
+        else if constexpr (std::is_integral_v<D>){
+            if constexpr (sizeof(D) <= 4) appendTagged(out, UInt32, (std::uint32_t)value);
+            else appendTagged(out, UInt64, (std::uint64_t)value);
+        }
+        else if constexpr (std::is_floating_point_v<D>){
+            appendTagged(out, Double, (double)value);
+        }
+        else if constexpr (std::is_convertible_v<const T&, std::string_view>){
+            // strings are cut to what is left of the payload of the record (starting at out[0])
+            std::string_view str(value);
+            std::size_t used = out.size() - sizeof(Header) + 3;
+            std::uint16_t len = (std::uint16_t)std::min<std::size_t>(str.size(), used < s_maxPayload ? s_maxPayload - used : 0);
+            appendTagged(out, String, len);
+            out.append(str.data(), len);
+        }
+        else if constexpr (std::is_pointer_v<D>){
+            appendTagged(out, Pointer, (std::uint64_t)(std::uintptr_t)value);
+        }
+        else{
+            static_assert(std::is_pointer_v<D>, "type not supported by deferred logging");
+        }
+    }
+
+    // expands printf-like fmt with the encoded arguments; conversions which don't fit the stored type
+    // get replaced by the default conversion of that type, missing arguments are printed as "<?>"
+    static void expand(std::string& out, const char* fmt, const char* args, std::size_t argsLen){
+        const char* argEnd = args + argsLen;
+        const char* p = fmt;
+
+        while(*p != '\0'){
+            if(*p != '%'){
+                const char* start = p;
+                while(*p != '\0' && *p != '%') ++p;
+                out.append(start, p - start);
+                continue;
+            }
+            if(p[1] == '%'){
+                out.push_back('%');
+                p += 2;
+                continue;
+            }
+
+            // collect flags, width and precision; skip length modifiers (type is known from tag)
+            // '*' takes width or precision from an integer argument, which gets written into spec
+            char spec[32];
+            std::size_t specLen = 0;
+            bool isValid = true;
+            spec[specLen++] = *p++;
+            while(*p != '\0' && std::strchr("-+ #0123456789.*", *p) != nullptr && specLen < 20){
+                if(*p != '*'){
+                    spec[specLen++] = *p++;
+                    continue;
+                }
+                ++p;
+                std::int64_t value = 0;
+                if(!readStarArg(args, argEnd, value)){
+                    isValid = false;
+                }
+                else if(value < 0 && spec[specLen - 1] == '.'){
+                    --specLen;      // negative precision counts as none
+                }
+                else{
+                    value = std::clamp<std::int64_t>(value, -s_maxStarValue, s_maxStarValue);
+                    specLen = std::to_chars(spec + specLen, spec + sizeof(spec), value).ptr - spec;
+                }
+            }
+            while(*p != '\0' && std::strchr("hljztL", *p) != nullptr){
+                ++p;
+            }
+            char conv = *p != '\0' ? *p++ : 's';
+
+            if(args >= argEnd){
+                out += "<?>";
+                continue;
+            }
+            if(!isValid){
+                // argument of the conversion is skipped, so that following ones still match
+                std::string skipped;
+                appendFormattedArg(skipped, spec, 1, conv, args, argEnd);
+                out += "<?>";
+                continue;
+            }
+            appendFormattedArg(out, spec, specLen, conv, args, argEnd);
+        }
+    }
+
+private:
+
+    static constexpr std::int64_t s_maxStarValue = 0xFFFF;          // width or precision given by '*'
+    static constexpr std::size_t s_maxConversionLen = 1 << 20;      // longer conversions (e.g. huge widths) print "<?>"
+
+    // takes argument of '*'; false (argument is skipped anyway) if it is missing or not an integer
+    static bool readStarArg(const char*& args, const char* argEnd, std::int64_t& value){
+        if(args >= argEnd){
+            return false;
+        }
+        ArgTag tag = (ArgTag)*args;
+        std::size_t size = tag == Int32 || tag == UInt32 ? 4 : (tag == Int64 || tag == UInt64 ? 8 : 0);
+        if(size == 0 || (std::size_t)(argEnd - args) < 1 + size){
+            std::string skipped;
+            char spec[2] = {'%', '\0'};
+            appendFormattedArg(skipped, spec, 1, 'd', args, argEnd);
+            return false;
+        }
+        ++args;
+        switch(tag){
+        case Int32: value = read<std::int32_t>(args); break;
+        case UInt32: value = read<std::uint32_t>(args); break;
+        case Int64: value = read<std::int64_t>(args); break;
+        default: value = (std::int64_t)std::min<std::uint64_t>(read<std::uint64_t>(args), INT64_MAX); break;
+        }
+        return true;
+    }
+
+    template<typename V>
+    static void appendTagged(std::string& out, ArgTag tag, V value){
+        out.push_back((char)tag);
+        out.append((const char*)&value, sizeof(value));
+    }
+
+    template<typename V>
+    static V read(const char*& args){
+        V value;
+        std::memcpy(&value, args, sizeof(V));
+        args += sizeof(V);
+        return value;
+    }
+
+    template<typename V>
+    static void appendPrintf(std::string& out, char* spec, std::size_t specLen, const char* lengthModifier, char conv, V value){
+        for(const char* m = lengthModifier; *m != '\0'; ++m){
+            spec[specLen++] = *m;
+        }
+        spec[specLen++] = conv;
+        spec[specLen] = '\0';
+
+        char buffer[128];
+        int len = std::snprintf(buffer, sizeof(buffer), spec, value);
+        if(len <= 0){
+            return;
+        }
+        if((std::size_t)len < sizeof(buffer)){
+            out.append(buffer, len);
+        }
+        else if((std::size_t)len <= s_maxConversionLen){
+            // didn't fit, so it gets formatted again directly into out
+            std::size_t start = out.size();
+            out.resize(start + len + 1);
+            std::snprintf(&out[start], len + 1, spec, value);
+            out.resize(start + len);
+        }
+        else{
+            out += "<?>";
+        }
+    }
+
+    static void appendFormattedArg(std::string& out, char* spec, std::size_t specLen, char conv, const char*& args, const char* argEnd){
+        ArgTag tag = (ArgTag)*args++;
+        bool intConv = std::strchr("diouxXc", conv) != nullptr;
+        bool floatConv = std::strchr("eEfFgGaA", conv) != nullptr;
+
+        // guard against truncated records
+        std::size_t need = 0;
+        switch(tag){
+        case Int32: case UInt32: need = 4; break;
+        case Int64: case UInt64: case Double: case Pointer: need = 8; break;
+        case String: need = 2; break;
+        case Char: case Bool: need = 1; break;
+        }
+        if(need == 0 || (std::size_t)(argEnd - args) < need){
+            args = argEnd;
+            out += "<?>";
+            return;
+        }
+
+        switch(tag){
+        case Int32:
+            appendPrintf(out, spec, specLen, "", intConv && conv != 'c' ? conv : 'd', read<std::int32_t>(args));
+            break;
+        case Int64:
+            appendPrintf(out, spec, specLen, "ll", intConv && conv != 'c' ? conv : 'd', (long long)read<std::int64_t>(args));
+            break;
+        case UInt32:
+            appendPrintf(out, spec, specLen, "", intConv && conv != 'c' ? conv : 'u', read<std::uint32_t>(args));
+            break;
+        case UInt64:
+            appendPrintf(out, spec, specLen, "ll", intConv && conv != 'c' ? conv : 'u', (unsigned long long)read<std::uint64_t>(args));
+            break;
+        case Double:
+            appendPrintf(out, spec, specLen, "", floatConv ? conv : 'g', read<double>(args));
+            break;
+        case Char:
+            appendPrintf(out, spec, specLen, "", intConv ? conv : 'c', (int)read<char>(args));
+            break;
+        case Bool:
+            if(intConv) appendPrintf(out, spec, specLen, "", conv, (int)read<std::uint8_t>(args));
+            else out += read<std::uint8_t>(args) ? "true" : "false";
+            break;
+        case Pointer:
+            appendPrintf(out, spec, specLen, "", 'p', (void*)(std::uintptr_t)read<std::uint64_t>(args));
+            break;
+        case String: {
+            std::uint16_t len = read<std::uint16_t>(args);
+            len = (std::uint16_t)std::min<std::size_t>(len, argEnd - args);
+            if(specLen == 1){
+                out.append(args, len);      // plain %s, no need for printf
+            }
+            else{
+                std::string str(args, len);
+                appendPrintf(out, spec, specLen, "", 's', str.c_str());
+            }
+            args += len;
+            break;
+        }
+        }
+    }
+};
+
+/* Derived Logger class to represent deferred log-entries: holds format id and raw arguments only,
+ * text gets composed in constructEntry (i.e. on LogThreader's thread if logger is handled by it) */
+class LogEntryDeferred : public LogEntry{
+public:
+    template<typename... Args>
+    LogEntryDeferred(const LogTimeFormatter* timeFormatter, LogLevel logLevel, std::uint32_t fmtId, std::int64_t timeNs, const Args&... args)
+    {
+        m_record.reserve(sizeof(LogRecordCodec::Header) + 16 * sizeof...(Args));
+        assign(timeFormatter, logLevel, fmtId, timeNs, args...);
+    }
+
+    // re-initializes entry (used by LogEntryPool); keeps capacity of record
+    template<typename... Args>
+    void assign(const LogTimeFormatter* timeFormatter, LogLevel logLevel, std::uint32_t fmtId, std::int64_t timeNs, const Args&... args){
+        m_timeFormatter = timeFormatter != nullptr ? timeFormatter : &defaultTimeFormatter();
+        m_record.clear();
+        LogRecordCodec::beginRecord(m_record, LogRecordCodec::Entry, logLevel, fmtId, timeNs);
+        (LogRecordCodec::appendArg(m_record, args), ...);
+        LogRecordCodec::finishRecord(m_record);
+    }
+
+    LogLevel getLogLevel() const override { return (LogLevel)header().level; }
+
+    void constructEntry() override{
+        LogRecordCodec::Header h = header();
+
+        m_entry.clear();
+        LogEntryText::addPrefix(m_entry, (LogLevel)h.level, "", h.timeNs, m_timeFormatter);
+        LogRecordCodec::expand(m_entry, LogFormatRegistry::get(h.fmtId), m_record.data() + sizeof(h), h.payloadLen);
+    }
+
+    // binary record (header + arguments) as written to .blog files
+    const std::string& getRecord() const { return m_record; }
+
+    std::uint32_t getFormatId() const { return header().fmtId; }
+
+private:
+    LogRecordCodec::Header header() const {
+        LogRecordCodec::Header h;
+        std::memcpy(&h, m_record.data(), sizeof(h));
+        return h;
+    }
+
+    std::string m_record;
+    const LogTimeFormatter* m_timeFormatter;    // only used for text composition
+};
+
+/* Derived Logger class to handle text logging (normal .log-files) */
+class TextLogger : public Logger{
+public:
+    TextLogger(std::string logFileName, LogLevel newLogLevel, bool logFileNameIsAbsolutePath=false, bool enableConsolePrinting=false, bool useCustomTime=false)      // for normal text logs
+        :Logger(enableConsolePrinting), m_logLevel(newLogLevel), m_useCustomTime(useCustomTime)
+    {
+        // if no specific logFileName provided, use default
+        if(logFileName == ""){
+            logFileName = "log0.log";
+        }
+
+        // if logfile has no file extension, add it
+        if(logFileName.substr(logFileName.size()-4, 4) != ".log"){
+            logFileName += ".log";
+        }
+
+        setup(logFileName, logFileNameIsAbsolutePath);
+
+        // check if passed log-level is valid (and get loglevel as string), else return
+        std::string levelStr = "";
+        if(!logLevelToStr(levelStr, m_logLevel.load())){
+            std::string errMsg = "Undefined LogLevel. Logger is terminating.";
+            std::unique_ptr<LogEntryText> entry = std::make_unique<LogEntryText>(LogLevel::Error, errMsg, "", 0);
+            print(move(entry));
+            return;
+        }
+
+        std::string initMsg = "Starting logger with log level " + levelStr;
+        std::unique_ptr<LogEntryText> entry = std::make_unique<LogEntryText>(LogLevel::Info, initMsg, "", 0);
+        print(move(entry));
+        
+    }
+
+    ~TextLogger(){
+        reportPendingSuppressed(true);
+
+        std::string infoMsg = "TextLogger has been shut down";
+        
+        std::unique_ptr<LogEntryText> entry = std::make_unique<LogEntryText>(LogLevel::Info, infoMsg, "", 0, timeFormatter());
+        print(move(entry), true);
+
+        // separator would break json lines and logfmt files
+        if(layout() == LogLayout::Text){
+            printRawToFile("------------------------------------------\n\n");
+        }
+    }
+
+    // create log entries
+    // write entries to m_logEntries
+    // entries come from a pool, so in steady state no allocation is needed
+    void log(std::string_view logEntry, LogLevel logLevel, std::string_view timeStr = ""){
+    
+        if(isEnabled(logLevel)) {
+
+            std::int64_t timeNs = 0;
+            if(!m_useCustomTime){
+                timeNs = LogTimeFormatter::nowNs();
+            }
+            logText(logEntry, logLevel, timeStr, timeNs);
+        }
+    }
+
+    // entry with a time stamp taken elsewhere (nanoseconds since epoch), e.g. entries of other processes (see LogShmWriter)
+    void logAt(std::string_view logEntry, LogLevel logLevel, std::int64_t timeNs){
+        if(isEnabled(logLevel)){
+            logText(logEntry, logLevel, "", timeNs);
+        }
+    }
+
+    // wrapper for above method
+    void log(const char* logEntry, LogLevel logLevel, std::string_view timeStr = ""){
+        log(std::string_view(logEntry), logLevel, timeStr);
+    }
+
+    // level known at compile time: compiles to nothing if level is above LOGGER_COMPILE_LEVEL
+    // (note that arguments are still evaluated by caller; use LOG_<LEVEL> macros to avoid that)
+    template<LogLevel Level>
+    void log(std::string_view logEntry, std::string_view timeStr = ""){
+        if constexpr (Level <= LOGGER_COMPILE_LEVEL){
+            log(logEntry, Level, timeStr);
+        }
+    }
+
+    // structured entry with typed fields (int, double, bool, strings), e.g.
+    //   static const LogKeys keys("status", "latency_ms");     (names are prepared once)
+    //   logger->logFields(LogLevel::Info, "request done", keys, status, latencyMs);
+    // or LOG_FIELDS(logger, LogLevel::Info, "request done", ("status", "latency_ms"), status, latencyMs)
+    // values are stored binary in the entry and rendered in layout of logger (see setLayout) when written
+    template<std::size_t N, typename... Values>
+    void logFields(LogLevel logLevel, std::string_view msg, const LogKeys<N>& keys, const Values&... values){
+        static_assert(N == sizeof...(Values), "amount of values does not match amount of names");
+
+        if(!isEnabled(logLevel)){
+            return;
+        }
+
+        std::int64_t timeNs = 0;
+        if(!m_useCustomTime){
+            timeNs = LogTimeFormatter::nowNs();
+        }
+
+        #ifdef __linux__
+        if(m_mappedSink){
+            thread_local LogEntryStructured entry(logLevel, "", 0, nullptr, nullptr);
+            entry.assign(logLevel, msg, timeNs, timeFormatter(), &keys, values...);
+            writeMapped(entry);
+            return;
+        }
+        #endif
+
+        LogEntryPtr entry = m_structuredPool->acquire(logLevel, msg, timeNs, timeFormatter(), &keys, values...);
+
+        if(isHandledByThreader()){
+            #if ENABLE_MULTITHREADING
+            enqueue(move(entry));
+            #endif
+        } else {
+            print(move(entry));
+        }
+    }
+
+    // layout of entries written from now on: text (default), json lines or logfmt
+    // should be set right after construction, so that all lines of a file have the same layout
+    void setLayout(LogLayout layout){
+        m_layout.store(layout, std::memory_order_relaxed);
+    }
+
+    LogLayout layout() const { return m_layout.load(std::memory_order_relaxed); }
+
+    // formatted logging, e.g. log<LogLevel::Info>("moved {} of {} items in {:.3f} s", done, total, seconds)
+    // format string is checked against the arguments at compile time (see LogFormatString); the message
+    // gets formatted directly into the (recycled) entry, so no temporary strings are created
+    // (a string literal without fields followed by one string is a message with custom time string, as log<Level>(msg, timeStr))
+    template<LogLevel Level, typename... Args>
+        requires (sizeof...(Args) > 0)
+    void log(LogFormatStringFor<Args...> fmt, const Args&... args){
+        if constexpr (Level <= LOGGER_COMPILE_LEVEL){
+            if(isEnabled(Level)){
+                if(!fmt.hasFields()){
+                    logCustomTime(Level, fmt.get(), args...);
+                    return;
+                }
+                logFormatted(Level, fmt.get(), args...);
+            }
+        }
+    }
+
+    // writes entries directly from calling thread into a preallocated, memory mapped file (see MappedLogSink)
+    // no queue and no syscall per entry, also if logger is handled by LogThreader; call before logging starts
+    // returns false if mapping is not possible (then normal file output is kept)
+    bool enableMappedOutput(std::size_t regionSize = 64 << 20){
+        #ifdef __linux__
+        std::unique_ptr<MappedLogSink> mappedSink = std::make_unique<MappedLogSink>(regionSize);
+        m_sink.close();
+        if(!mappedSink->open(m_logFilePath)){
+            m_sink.open(m_logFilePath, true);
+            return false;
+        }
+        m_mappedSink = std::move(mappedSink);
+        return true;
+        #else
+        (void)regionSize;
+        return false;
+        #endif
+    }
+
+    // true if entries of given level would be written
+    bool isEnabled(LogLevel logLevel) const {
+        return logLevel <= LOGGER_COMPILE_LEVEL && logLevel <= m_logLevel.load(std::memory_order_relaxed);
+    }
+
+    // only captures format id and raw arguments; message text gets composed by LogThreader (use LOG_DEFERRED macro)
+    // always uses real time, custom time strings are not supported here
+    template<typename... Args>
+    void logDeferred(LogLevel logLevel, std::uint32_t fmtId, const Args&... args){
+
+        if(isEnabled(logLevel)){
+
+            LogEntryPtr entry = m_deferredPool->acquire(timeFormatter(), logLevel, fmtId, LogTimeFormatter::nowNs(), args...);
+
+            if(isHandledByThreader()){
+                #if ENABLE_MULTITHREADING
+                enqueue(move(entry));
+                #endif
+            } else {
+                print(move(entry));
+            }
+        }
+    }
+
+    // allows to change loglevel after logger-construction (also from other threads while logging)
+    // e.g. to increase loglevel temporarely; levels above LOGGER_COMPILE_LEVEL stay disabled nevertheless
+    void setLogLevel(LogLevel newLogLevel){
+        m_logLevel.store(newLogLevel, std::memory_order_relaxed);
+    }
+
+    // changes layout of real time stamps (e.g. add milliseconds or use UTC); affects also entries already queued
+    void setTimestampFormat(const TimestampFormat& format){
+        // formatters are kept until logger gets destroyed, as queued entries still point to previous one
+        m_timeFormatters.push_back(std::make_unique<LogTimeFormatter>(format));
+        m_timeFormatter.store(m_timeFormatters.back().get(), std::memory_order_release);
+    }
+
+private:
+
+    void reportSuppressed(const std::string& msg) override{
+        log(msg, LogLevel::Warning);
+    }
+
+    #ifdef __linux__
+    // composes entry on calling thread and copies it into mapped file
+    void writeMapped(LogEntryText& entry){
+        entry.setLayout(layout());
+        entry.constructEntry();
+        if(m_enableConsolePrinting){
+            printToConsole(entry.getEntry());
+        }
+        m_mappedSink->write(entry.getEntry());
+    }
+    #endif
+
+    const LogTimeFormatter* timeFormatter() const {
+        return m_timeFormatter.load(std::memory_order_acquire);
+    }
+
+    // log<Level>(msg, timeStr) with a string literal as message (see LogFormatString)
+    template<typename... Args>
+    void logCustomTime(LogLevel logLevel, std::string_view msg, const Args&... args){
+        if constexpr (sizeof...(Args) == 1 && (std::is_convertible_v<const Args&, std::string_view> && ...)){
+            log(msg, logLevel, std::string_view(args...));
+        }
+    }
+
+    // writes (or queues) text entry; level has been checked by caller
+    void logText(std::string_view logEntry, LogLevel logLevel, std::string_view timeStr, std::int64_t timeNs){
+
+        #ifdef __linux__
+        if(m_mappedSink){
+            // entry is composed right here and copied into the mapped file, no queue involved
+            if(layout() != LogLayout::Text){
+                thread_local LogEntryText entry(logLevel, "");
+                entry.assign(logLevel, logEntry, timeStr, timeNs, timeFormatter());
+                writeMapped(entry);
+                return;
+            }
+            thread_local std::string line;
+            line.clear();
+            LogEntryText::addPrefix(line, logLevel, timeStr, timeNs, timeFormatter());
+            line += logEntry;
+            if(m_enableConsolePrinting){
+                printToConsole(line);
+            }
+            m_mappedSink->write(line);
+            return;
+        }
+        #endif
+
+        LogEntryPtr entry = m_textPool->acquire(logLevel, logEntry, timeStr, timeNs, timeFormatter());
+
+        if(isHandledByThreader()){
+            #if ENABLE_MULTITHREADING
+            // write to queue
+            enqueue(move(entry));
+            #endif
+        } else {
+            // write to log
+            print(move(entry));
+        }
+    }
+
+    // same as log(msg, level), but message gets formatted into the entry (or line) in place
+    template<typename... Args>
+    void logFormatted(LogLevel logLevel, std::string_view fmt, const Args&... args){
+
+        std::int64_t timeNs = 0;
+        if(!m_useCustomTime){
+            timeNs = LogTimeFormatter::nowNs();
+        }
+
+        #ifdef __linux__
+        if(m_mappedSink){
+            if(layout() != LogLayout::Text){
+                // message has to be escaped, so it can't be formatted into the line directly
+                thread_local LogEntryText entry(logLevel, "");
+                entry.assign(logLevel, std::string_view(), std::string_view(), timeNs, timeFormatter());
+                LogFormat::format(entry.message(), fmt, args...);
+                writeMapped(entry);
+                return;
+            }
+            thread_local std::string line;
+            line.clear();
+            LogEntryText::addPrefix(line, logLevel, "", timeNs, timeFormatter());
+            LogFormat::format(line, fmt, args...);
+            if(m_enableConsolePrinting){
+                printToConsole(line);
+            }
+            m_mappedSink->write(line);
+            return;
+        }
+        #endif
+
+        std::unique_ptr<LogEntryText, LogEntryRecycler> textEntry = m_textPool->acquire(logLevel, std::string_view(), std::string_view(), timeNs, timeFormatter());
+        LogFormat::format(textEntry->message(), fmt, args...);
+        LogEntryPtr entry = std::move(textEntry);
+
+        if(isHandledByThreader()){
+            #if ENABLE_MULTITHREADING
+            enqueue(move(entry));
+            #endif
+        } else {
+            print(move(entry));
+        }
+    }
+
+    std::atomic<LogLevel> m_logLevel;
+
+    bool m_useCustomTime;
+
+    std::atomic<const LogTimeFormatter*> m_timeFormatter{&defaultTimeFormatter()};
+    std::vector<std::unique_ptr<LogTimeFormatter>> m_timeFormatters;
+
+    std::atomic<LogLayout> m_layout{LogLayout::Text};
+
+    LogEntryPool<LogEntryText>* m_textPool = createEntryPool<LogEntryText>();
+    LogEntryPool<LogEntryDeferred>* m_deferredPool = createEntryPool<LogEntryDeferred>();
+    LogEntryPool<LogEntryStructured>* m_structuredPool = createEntryPool<LogEntryStructured>();
+
+    // construct entry, give command to write to console and/or file
+    void print(LogEntryPtr entry, bool enforceConsoleWriting=false) override{
+
+        entry->setLayout(layout());
+        entry->constructEntry();
+        const std::string& msg = entry->getEntry();
+
+        // make entries at different locations
+        if(m_enableConsolePrinting || enforceConsoleWriting){
+            printToConsole(msg);
+        }
+
+        printToFile(msg, entry->getLogLevel(), entry->getTimeNs());
+    }
+};
+
+/* Derived Logger class to handle text logging (normal .log-files) */
+class CsvLogger : public Logger{
+public:
+    CsvLogger(std::string logFileName, bool logFileNameIsAbsolutePath=false)
+        :Logger(false){
+        // if no specific logFileName provided, use default
+        if(logFileName == ""){
+            logFileName = "csv0.csv";
+        }
+
+        // if logfile has no file extension, add it
+        if(logFileName.substr(logFileName.size()-4, 4) != ".csv"){
+            logFileName += ".csv";
+        }
+
+        setup(logFileName, logFileNameIsAbsolutePath);
+    }
+
+    ~CsvLogger(){
+
+        std::string infoMsg = "CsvLogger has been shut down";
+        printToConsole(infoMsg);
+
+    }
+
+    // create log entries
+    // write entries to m_logEntries
+    void log(std::string_view logEntry){
+
+        LogEntryPtr entry = m_rowPool->acquire(logEntry);
+        submit(move(entry));
+    }
+
+    void log(const char* logEntry){
+        log(std::string_view(logEntry));
+    }
+
+protected:
+
+    // hands entry over to queue or writes it directly
+    void submit(LogEntryPtr entry){
+        if(isHandledByThreader()){
+            #if ENABLE_MULTITHREADING
+            // write to queue
+            enqueue(move(entry));
+            #endif
+        } else {
+            // write to log
+            print(move(entry));
+        }
+    }
+
+    // amount of columns; gets set on first entry according to amount of semicolons (or by TypedCsvLogger)
+    int m_nColumns = 0;
+
+    bool m_checkColumns = true;     // count columns of every row (not needed if rows are typed)
+
+private:
+
+    // construct entry, give command to write to console and/or file
+    void print(LogEntryPtr entry, bool enforceConsoleWriting=false) override{
+
+        entry->constructEntry();
+        const std::string& msg = entry->getEntry();
+
+        // check amount of columns
+        if(!m_checkColumns){
+            // nothing to do, amount of columns is guaranteed at compile time
+        }
+        else if(m_nColumns == 0){    // first time
+            m_nColumns = (int)std::count(msg.begin(), msg.end(), ',');
+            ++m_nColumns;   // there is always one more column than semicolons
+
+        }
+        else {  // every other time
+            int count = 1 + (int)std::count(msg.begin(), msg.end(), ',');  // there is always one more column than semicolons
+            if(count != m_nColumns){
+                std::string warningMsg = "WARNING! Amount of columns (" + std::to_string(count) + ") does not correspond to columns in first row (" + std::to_string(m_nColumns) + ")";
+                printToConsole(warningMsg);
+            }
+        }
+
+        if(enforceConsoleWriting) printToConsole(msg);
+
+        // first row (usually header) gets repeated in rotated files
+        if(!m_hasFirstRow){
+            m_firstRow = msg;
+            m_hasFirstRow = true;
+        }
+
+        printToFile(msg);
+    }
+
+    void writeFileHeader() override{
+        if(m_hasFirstRow){
+            m_sink.write(m_firstRow);
+        }
+    }
+
+protected:
+    LogEntryPool<LogEntry>* m_rowPool = createEntryPool<LogEntry>();
+
+    std::string m_firstRow;
+    bool m_hasFirstRow = false;
+};
+
+// writes single values into csv rows
+struct CsvFormat{
+    // numbers are written with std::to_chars (shortest representation which reads back to the same value)
+    template<typename T>
+    static void appendValue(std::string& out, const T& value){
+        using D = std::decay_t<T>;
+        if constexpr (std::is_same_v<D, bool>){
+            out.push_back(value ? '1' : '0');
+        }
+        else if constexpr (std::is_arithmetic_v<D>){
+            char buffer[64];
+            std::to_chars_result result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+            out.append(buffer, result.ptr - buffer);
+        }
+        else if constexpr (std::is_convertible_v<const T&, std::string_view>){
+            appendString(out, std::string_view(value));
+        }
+        else{
+            static_assert(std::is_arithmetic_v<D>, "column type not supported by csv logging");
+        }
+    }
+
+    // strings are quoted if they contain separator, quotes or line breaks
+    static void appendString(std::string& out, std::string_view str){
+        if(str.find_first_of(",\"\n\r") == std::string_view::npos){
+            out += str;
+            return;
+        }
+        out.push_back('"');
+        for(char c : str){
+            if(c == '"') out.push_back('"');
+            out.push_back(c);
+        }
+        out.push_back('"');
+    }
+
+    // writes all values of tuple separated by commas
+    template<typename Tuple>
+    static void appendRow(std::string& out, const Tuple& values){
+        std::apply([&out](const auto&... value){
+            bool first = true;
+            ((out.append(first ? "" : ","), first = false, appendValue(out, value)), ...);
+        }, values);
+    }
+};
+
+/* Entry holding the raw values of one csv row; text gets composed in constructEntry (i.e. on LogThreader's thread) */
+template<typename... Columns>
+class LogEntryCsvRow : public LogEntry{
+public:
+    template<typename... Values>
+    LogEntryCsvRow(const Values&... values)
+        :m_values(values...)
+    {}
+
+    // re-initializes entry (used by LogEntryPool)
+    template<typename... Values>
+    void assign(const Values&... values){
+        m_values = std::tuple<const Values&...>(values...);
+    }
+
+    void constructEntry() override{
+        m_entry.clear();
+        CsvFormat::appendRow(m_entry, m_values);
+    }
+
+    const std::tuple<Columns...>& getValues() const { return m_values; }
+
+private:
+    std::tuple<Columns...> m_values;
+};
+
+/* Csv logger with column types and amount of columns known at compile time
+ * e.g. TypedCsvLogger<double, double, double, double> logger("kinState.csv", {"t", "s", "v", "a"});
+ *      logger.logRow(t, s, v, a); */
+template<typename... Columns>
+class TypedCsvLogger : public CsvLogger{
+public:
+    static constexpr std::size_t s_nColumns = sizeof...(Columns);
+
+    TypedCsvLogger(std::string logFileName, const std::array<std::string_view, sizeof...(Columns)>& header, bool logFileNameIsAbsolutePath=false)
+        :CsvLogger(logFileName, logFileNameIsAbsolutePath)
+    {
+        m_nColumns = (int)s_nColumns;
+        m_checkColumns = false;
+
+        // write header
+        std::string row;
+        for(std::size_t i = 0; i < header.size(); ++i){
+            if(i > 0) row += ",";
+            CsvFormat::appendString(row, header[i]);
+        }
+        CsvLogger::log(row);
+    }
+
+    // writes one row; values are only copied here, formatting is done when entry gets written
+    template<typename... Values>
+    void logRow(const Values&... values){
+        static_assert(sizeof...(Values) == sizeof...(Columns), "amount of values does not match amount of columns");
+
+        LogEntryPtr entry = m_typedRowPool->acquire(values...);
+        submit(move(entry));
+    }
+
+    // untyped rows would bypass column check
+    void log(std::string_view logEntry) = delete;
+    void log(const char* logEntry) = delete;
+
+private:
+    LogEntryPool<LogEntryCsvRow<Columns...>>* m_typedRowPool = createEntryPool<LogEntryCsvRow<Columns...>>();
+};
+
+
+/* Binary columnar file format (.ccol) written by ColumnarCsvLogger
+ *   file header:  magic, amount of columns, rows per chunk, then per column: type, name length, name
+ *   chunks:       chunk header (magic, amount of rows), then the values of each column one after another
+ *                 (fixed width, native byte order, every column block starts 8 byte aligned)
+ *   index:        per chunk: file offset and amount of rows
+ *   footer:       offset of index, amount of chunks, magic
+ * a file without footer (e.g. after a crash) can still be read by walking from chunk to chunk */
+struct ColumnarFormat{
+    enum Type : std::uint8_t {
+        Int8 = 1, Int16, Int32, Int64,
+        UInt8, UInt16, UInt32, UInt64,
+        Float, Double, Bool
+    };
+
+    static constexpr char s_fileMagic[8] = {'C', 'C', 'O', 'L', '0', '0', '0', '1'};
+    static constexpr std::uint32_t s_chunkMagic = 0x4B4E4843;      // "CHNK"
+    static constexpr std::uint32_t s_footerMagic = 0x58444943;     // "CIDX"
+
+    struct ChunkHeader{
+        std::uint32_t magic;
+        std::uint32_t nRows;
+    };
+
+    struct IndexEntry{
+        std::uint64_t offset;
+        std::uint64_t nRows;
+    };
+
+    struct Footer{
+        std::uint64_t indexOffset;
+        std::uint32_t nChunks;
+        std::uint32_t magic;
+    };
+
+    template<typename T>
+    static constexpr Type typeOf(){
+        using D = std::decay_t<T>;
+        if constexpr (std::is_same_v<D, bool>) return Bool;
+        else if constexpr (std::is_same_v<D, float>) return Float;
+        else if constexpr (std::is_same_v<D, double>) return Double;
+        else if constexpr (std::is_integral_v<D> && std::is_signed_v<D> && sizeof(D) == 1) return Int8;
+        else if constexpr (std::is_integral_v<D> && std::is_signed_v<D> && sizeof(D) == 2) return Int16;
+        else if constexpr (std::is_integral_v<D> && std::is_signed_v<D> && sizeof(D) == 4) return Int32;
+        else if constexpr (std::is_integral_v<D> && std::is_signed_v<D> && sizeof(D) == 8) return Int64;
+        else if constexpr (std::is_integral_v<D> && std::is_unsigned_v<D> && sizeof(D) == 1) return UInt8;
+        else if constexpr (std::is_integral_v<D> && std::is_unsigned_v<D> && sizeof(D) == 2) return UInt16;
+        else if constexpr (std::is_integral_v<D> && std::is_unsigned_v<D> && sizeof(D) == 4) return UInt32;
+        else if constexpr (std::is_integral_v<D> && std::is_unsigned_v<D> && sizeof(D) == 8) return UInt64;
+        else static_assert(std::is_arithmetic_v<D>, "columnar csv supports arithmetic column types only");
+    }
+
+    static std::size_t widthOf(Type type){
+        switch(type){
+        case Int8: case UInt8: case Bool: return 1;
+        case Int16: case UInt16: return 2;
+        case Int32: case UInt32: case Float: return 4;
+        case Int64: case UInt64: case Double: return 8;
+        }
+        return 0;
+    }
+
+    // bytes needed to reach next multiple of 8
+    static std::size_t padding(std::uint64_t offset){
+        return (8 - offset % 8) % 8;
+    }
+};
+
+/* Numeric telemetry in binary columnar layout instead of text csv (see ColumnarFormat)
+ * same interface as TypedCsvLogger; use logtool to convert file to csv
+ * e.g. ColumnarCsvLogger<double, double, double, double> logger("kinState.ccol", {"t", "s", "v", "a"}); */
+template<typename... Columns>
+class ColumnarCsvLogger : public Logger{
+public:
+    static constexpr std::size_t s_nColumns = sizeof...(Columns);
+
+    ColumnarCsvLogger(std::string logFileName, const std::array<std::string_view, sizeof...(Columns)>& header, bool logFileNameIsAbsolutePath=false, std::uint32_t rowsPerChunk=4096)
+        :Logger(false), m_rowsPerChunk(rowsPerChunk > 0 ? rowsPerChunk : 1)
+    {
+        // if no specific logFileName provided, use default
+        if(logFileName == ""){
+            logFileName = "csv0.ccol";
+        }
+
+        // if logfile has no file extension, add it
+        if(logFileName.size() < 5 || logFileName.substr(logFileName.size()-5, 5) != ".ccol"){
+            logFileName += ".ccol";
+        }
+
+        setup(logFileName, logFileNameIsAbsolutePath);
+
+        // write file header
+        std::string fileHeader(ColumnarFormat::s_fileMagic, sizeof(ColumnarFormat::s_fileMagic));
+        appendPod(fileHeader, (std::uint32_t)s_nColumns);
+        appendPod(fileHeader, m_rowsPerChunk);
+        constexpr ColumnarFormat::Type types[] = {ColumnarFormat::typeOf<Columns>()...};
+        for(std::size_t i = 0; i < s_nColumns; ++i){
+            appendPod(fileHeader, (std::uint8_t)types[i]);
+            appendPod(fileHeader, (std::uint16_t)header[i].size());
+            fileHeader.append(header[i].data(), header[i].size());
+        }
+        fileHeader.append(ColumnarFormat::padding(fileHeader.size()), '\0');
+        writeData(fileHeader);
+
+        for(std::size_t i = 0; i < s_nColumns; ++i){
+            m_columns[i].reserve(m_rowsPerChunk * ColumnarFormat::widthOf(types[i]));
+        }
+    }
+
+    ~ColumnarCsvLogger(){
+        writeChunk();
+
+        // index and footer
+        std::string index;
+        for(const ColumnarFormat::IndexEntry& entry : m_index){
+            appendPod(index, entry);
+        }
+        ColumnarFormat::Footer footer{m_fileOffset, (std::uint32_t)m_index.size(), ColumnarFormat::s_footerMagic};
+        appendPod(index, footer);
+        writeData(index);
+
+        std::string infoMsg = "ColumnarCsvLogger has been shut down";
+        printToConsole(infoMsg);
+    }
+
+    // writes one row (see TypedCsvLogger::logRow)
+    template<typename... Values>
+    void logRow(const Values&... values){
+        static_assert(sizeof...(Values) == sizeof...(Columns), "amount of values does not match amount of columns");
+
+        LogEntryPtr entry = m_rowPool->acquire(values...);
+        if(isHandledByThreader()){
+            #if ENABLE_MULTITHREADING
+            enqueue(move(entry));
+            #endif
+        } else {
+            print(move(entry));
+        }
+    }
+
+private:
+
+    template<typename T>
+    static void appendPod(std::string& out, const T& value){
+        out.append((const char*)&value, sizeof(T));
+    }
+
+    void writeData(const std::string& data){
+        m_sink.writeRaw(data);
+        m_fileOffset += data.size();
+    }
+
+    // appends values of row to column buffers; writes chunk if full
+    void print(LogEntryPtr entry, bool enforceConsoleWriting=false) override{
+        (void)enforceConsoleWriting;
+
+        const auto& values = static_cast<LogEntryCsvRow<Columns...>*>(entry.get())->getValues();
+        appendRow(values, std::index_sequence_for<Columns...>());
+
+        if(++m_nRows >= m_rowsPerChunk){
+            writeChunk();
+        }
+    }
+
+    template<std::size_t... I>
+    void appendRow(const std::tuple<Columns...>& values, std::index_sequence<I...>){
+        (appendPod(m_columns[I], std::get<I>(values)), ...);
+    }
+
+    void writeChunk(){
+        if(m_nRows == 0){
+            return;
+        }
+
+        m_index.push_back({m_fileOffset, m_nRows});
+
+        std::string chunkHeader;
+        appendPod(chunkHeader, ColumnarFormat::ChunkHeader{ColumnarFormat::s_chunkMagic, m_nRows});
+        writeData(chunkHeader);
+
+        for(std::size_t i = 0; i < s_nColumns; ++i){
+            m_columns[i].append(ColumnarFormat::padding(m_columns[i].size()), '\0');
+            writeData(m_columns[i]);
+            m_columns[i].clear();
+        }
+        m_nRows = 0;
+    }
+
+    // unfinished chunk is written as it is (flush and sync requests need its rows in the file)
+    void flushPending() override{
+        writeChunk();
+    }
+
+    // unfinished chunk is written as it is; without footer readers find the chunks by walking their headers
+    void emergencyFlush() override{
+        writeChunk();
+        Logger::emergencyFlush();
+    }
+
+    std::uint32_t m_rowsPerChunk;
+    std::uint32_t m_nRows = 0;                  // rows in current chunk
+    std::uint64_t m_fileOffset = 0;             // bytes written so far
+
+    std::array<std::string, sizeof...(Columns)> m_columns;     // values of current chunk, one buffer per column
+    std::vector<ColumnarFormat::IndexEntry> m_index;
+
+    LogEntryPool<LogEntryCsvRow<Columns...>>* m_rowPool = createEntryPool<LogEntryCsvRow<Columns...>>();
+};
+
+/* Derived Logger class to write deferred entries as binary records (.blog-files)
+ * no text gets composed at all; use decoder of logtool to convert file to normal .log-layout */
+class BinaryLogger : public Logger{
+public:
+    BinaryLogger(std::string logFileName, LogLevel newLogLevel, bool logFileNameIsAbsolutePath=false)
+        :Logger(false), m_logLevel(newLogLevel)
+    {
+        // if no specific logFileName provided, use default
+        if(logFileName == ""){
+            logFileName = "log0.blog";
+        }
+
+        // if logfile has no file extension, add it
+        if(logFileName.size() < 5 || logFileName.substr(logFileName.size()-5, 5) != ".blog"){
+            logFileName += ".blog";
+        }
+
+        setup(logFileName, logFileNameIsAbsolutePath);
+
+        writeFileHeader();
+
+        std::string levelStr = "";
+        logLevelToStr(levelStr, m_logLevel.load());
+        logDeferred(LogLevel::Info, s_fmtStart, levelStr);
+    }
+
+    ~BinaryLogger(){
+        reportPendingSuppressed(true);
+
+        std::unique_ptr<LogEntryDeferred> entry = std::make_unique<LogEntryDeferred>(nullptr, LogLevel::Info, s_fmtShutdown, nowNs());
+        print(move(entry));
+
+        std::string record;
+        LogRecordCodec::beginRecord(record, LogRecordCodec::SessionEnd, LogLevel::Info, 0, nowNs());
+        m_sink.writeRaw(record);
+    }
+
+    // see TextLogger::logDeferred
+    template<typename... Args>
+    void logDeferred(LogLevel logLevel, std::uint32_t fmtId, const Args&... args){
+
+        if(isEnabled(logLevel)){
+            LogEntryPtr entry = m_deferredPool->acquire(nullptr, logLevel, fmtId, nowNs(), args...);
+
+            if(isHandledByThreader()){
+                #if ENABLE_MULTITHREADING
+                enqueue(move(entry));
+                #endif
+            } else {
+                print(move(entry));
+            }
+        }
+    }
+
+    // plain messages are stored as deferred entry with format "%s"
+    void log(std::string_view logEntry, LogLevel logLevel){
+        logDeferred(logLevel, s_fmtPlain, logEntry);
+    }
+
+    // see TextLogger::log<Level>
+    template<LogLevel Level>
+    void log(std::string_view logEntry){
+        if constexpr (Level <= LOGGER_COMPILE_LEVEL){
+            log(logEntry, Level);
+        }
+    }
+
+    bool isEnabled(LogLevel logLevel) const {
+        return logLevel <= LOGGER_COMPILE_LEVEL && logLevel <= m_logLevel.load(std::memory_order_relaxed);
+    }
+
+    void setLogLevel(LogLevel newLogLevel){
+        m_logLevel.store(newLogLevel, std::memory_order_relaxed);
+    }
+
+private:
+
+    static std::int64_t nowNs(){
+        return LogTimeFormatter::nowNs();
+    }
+
+    void reportSuppressed(const std::string& msg) override{
+        log(msg, LogLevel::Warning);
+    }
+
+    // every session starts with magic number, so that decoder knows that format ids start anew
+    // (rotated files start a new session, so that each of them can be decoded on its own)
+    void writeFileHeader() override{
+        std::string record(LogRecordCodec::s_magic, sizeof(LogRecordCodec::s_magic));
+        LogRecordCodec::beginRecord(record, LogRecordCodec::SessionStart, LogLevel::Info, 0, nowNs());
+        m_sink.writeRaw(record);
+        m_definedFormats.assign(m_definedFormats.size(), false);
+    }
+
+    // write record, preceded by definition of its format string if not yet done in this session
+    void print(LogEntryPtr entry, bool enforceConsoleWriting=false) override{
+
+        rotateFileIfDue();
+
+        LogEntryDeferred* deferred = dynamic_cast<LogEntryDeferred*>(entry.get());
+        if(deferred == nullptr){
+            // other entry types are stored as plain text
+            entry->constructEntry();
+            deferred = new LogEntryDeferred(nullptr, entry->getLogLevel(), s_fmtPlain, nowNs(), entry->getEntry());
+            entry = LogEntryPtr(deferred);
+        }
+
+        std::uint32_t fmtId = deferred->getFormatId();
+        if(fmtId >= m_definedFormats.size()){
+            m_definedFormats.resize(fmtId + 1, false);
+        }
+        if(!m_definedFormats[fmtId]){
+            const char* fmt = LogFormatRegistry::get(fmtId);
+            std::string def;
+            LogRecordCodec::beginRecord(def, LogRecordCodec::FormatDef, LogLevel::Info, fmtId, 0);
+            def.append(fmt);
+            LogRecordCodec::finishRecord(def);
+            m_sink.writeRaw(def);
+            m_definedFormats[fmtId] = true;
+        }
+
+        if(enforceConsoleWriting){
+            entry->constructEntry();
+            printToConsole(entry->getEntry());
+        }
+
+        m_sink.writeRaw(deferred->getRecord(), deferred->getLogLevel());
+    }
+
+    std::atomic<LogLevel> m_logLevel;
+
+    std::vector<bool> m_definedFormats;     // format ids already defined in current session
+
+    LogEntryPool<LogEntryDeferred>* m_deferredPool = createEntryPool<LogEntryDeferred>();
+
+    inline static const std::uint32_t s_fmtPlain = LogFormatRegistry::add("%s");
+    inline static const std::uint32_t s_fmtStart = LogFormatRegistry::add("Starting logger with log level %s");
+    inline static const std::uint32_t s_fmtShutdown = LogFormatRegistry::add("BinaryLogger has been shut down");
+};
+
+// logs printf-like message of which only format id and raw arguments are captured at call site
+// fmt has to be a string literal; text gets composed by LogThreader or offline (BinaryLogger)
+#define LOG_DEFERRED(logger, logLevel, fmt, ...) \
+    do { \
+        static const std::uint32_t logFormatId_ = LogFormatRegistry::add(fmt); \
+        (logger)->logDeferred((logLevel), logFormatId_ __VA_OPT__(,) __VA_ARGS__); \
+    } while(0)
+
+// logging with level filtering at compile time: LOG_DEBUG(logger, msg), LOG_DEBUG(logger, msg, timeStr)
+// or (text loggers) LOG_DEBUG(logger, "format {}", args...)
+// levels above LOGGER_COMPILE_LEVEL compile to nothing, below it arguments are only evaluated if level is enabled at runtime
+// every macro call is a call site of its own, which may be rate limited (see Logger::setRateLimit)
+#define LOG_AT_LEVEL(logger, logLevel, ...) \
+    do { \
+        if constexpr ((logLevel) <= LOGGER_COMPILE_LEVEL) { \
+            static LogCallSite logCallSite_(__FILE__, __LINE__); \
+            if((logger)->isEnabled(logLevel) && (logger)->allowCallSite(logCallSite_, logLevel)) (logger)->template log<(logLevel)>(__VA_ARGS__); \
+        } \
+    } while(0)
+
+// structured entry (see TextLogger::logFields); names are given in parentheses and prepared once
+// e.g. LOG_FIELDS(logger, LogLevel::Info, "request done", ("status", "latency_ms"), status, latencyMs)
+#define LOG_FIELDS(logger, logLevel, msg, names, ...) \
+    do { \
+        if constexpr ((logLevel) <= LOGGER_COMPILE_LEVEL) { \
+            static const LogKeys logFieldKeys_ names; \
+            if((logger)->isEnabled(logLevel)) (logger)->logFields((logLevel), (msg), logFieldKeys_, __VA_ARGS__); \
+        } \
+    } while(0)
+
+// like LOG_AT_LEVEL, but with own limit for this call site, e.g.
+// LOG_LIMITED(logger, LogLevel::Warning, LogRateLimit::rate(10, 5), "retry {} failed", n) or LogRateLimit::sampled(100)
+#define LOG_LIMITED(logger, logLevel, limit, ...) \
+    do { \
+        if constexpr ((logLevel) <= LOGGER_COMPILE_LEVEL) { \
+            static const LogRateLimit logRateLimit_ = (limit); \
+            static LogCallSite logCallSite_(__FILE__, __LINE__, &logRateLimit_); \
+            if((logger)->isEnabled(logLevel) && (logger)->allowCallSite(logCallSite_, logLevel)) (logger)->template log<(logLevel)>(__VA_ARGS__); \
+        } \
+    } while(0)
+
+#define LOG_ERROR(logger, ...)   LOG_AT_LEVEL(logger, LogLevel::Error, __VA_ARGS__)
+#define LOG_WARNING(logger, ...) LOG_AT_LEVEL(logger, LogLevel::Warning, __VA_ARGS__)
+#define LOG_INFO(logger, ...)    LOG_AT_LEVEL(logger, LogLevel::Info, __VA_ARGS__)
+#define LOG_DEBUG(logger, ...)   LOG_AT_LEVEL(logger, LogLevel::Debug, __VA_ARGS__)
+
+#if ENABLE_MULTITHREADING
+/* Class to handle multiple log-files in single thread */
+// snapshot of what a LogThreader has done so far (see LogThreader::getStats)
+struct LogThreaderStats{
+    std::size_t workers = 0;
+    std::size_t loggers = 0;
+    std::uint64_t written = 0;          // entries written by all workers
+    std::uint64_t rounds = 0;           // passes over all assigned queues
+    std::uint64_t wakeups = 0;          // times a worker went to sleep and woke up again
+    std::uint64_t steals = 0;           // loggers taken over by idle workers
+};
+
+class LogThreader {
+public:
+    // maxLatency: 0 -> every log call wakes the sleeping threader immediately
+    //             >0 -> threader wakes up at least every maxLatency and drains everything collected so far,
+    //                   producers only wake it earlier if a queue gets half full (coalesces writes)
+    // nWorkers: amount of threads writing entries; every logger is handled by one worker at a time (keeps order per file),
+    //           idle workers take over loggers of overloaded ones
+    LogThreader(std::chrono::microseconds maxLatency=std::chrono::microseconds(0), std::size_t nWorkers=1){
+        m_loggerRunning = true;
+        setMaxLatency(maxLatency);
+        consoleMutex.lock();
+        std::cout << "LogThreader INFO: starting threader from thread id " << std::this_thread::get_id() << std::endl;
+        consoleMutex.unlock();
+
+        // all workers have to exist before the first one starts looking at the others
+        for(std::size_t i = 0; i < std::max<std::size_t>(nWorkers, 1); ++i){
+            m_workers.push_back(std::make_unique<Worker>());
+        }
+        for(std::size_t i = 0; i < m_workers.size(); ++i){
+            m_workers[i]->thread = std::thread(&LogThreader::logging, this, i);
+        }
+    }
+
+    ~LogThreader(){
+        m_loggerRunning = false;
+        for(auto& worker : m_workers){
+            worker->signal.wake();
+        }
+        for(auto& worker : m_workers){
+            worker->thread.join();   // wait for logging method to finish
+        }
+
+        // entries a worker couldn't see anymore (e.g. logger was taken over while it was shutting down)
+        for(auto& logger : m_handledLoggers){
+            while(drainBatch(*logger) > 0){}
+            logger->m_sink.flush();
+            logger->m_sink.settle();
+        }
+
+        // loggers might outlive threader, so they have to go back to work on their own
+        for(auto& logger : m_handledLoggers){
+            logger->m_sink.setGroupCommit(false);
+            logger->m_signal.store(nullptr, std::memory_order_release);
+            logger->m_isHandledByThreader.store(false, std::memory_order_release);
+        }
+
+        consoleMutex.lock();
+        std::cout << "LogThreader INFO: threader has been shut down" << std::endl;
+        consoleMutex.unlock();
+    }
+
+    // add new logger to be handled; it gets assigned to the worker with fewest loggers
+    void addLogger(std::shared_ptr<Logger> logger){
+
+        std::string msgString = "Logger is now handled by LogThreader in separate thread";
+        
+        // if csv or binary file write to console only
+        if(logger->m_logFilePath.substr(logger->m_logFilePath.size()-4, 4) != ".log"){
+            logger->printToConsole(msgString);
+        }
+        if(logger->m_logFilePath.substr(logger->m_logFilePath.size()-4, 4) == ".log"){
+            std::unique_ptr<LogEntryText> msg = std::make_unique<LogEntryText>(LogLevel::Info, msgString);
+            logger->print(move(msg));
+        }
+
+        std::lock_guard<std::mutex> lock(m_loggersMutex);
+
+        std::size_t workerIndex = 0;
+        for(std::size_t i = 1; i < m_workers.size(); ++i){
+            if(m_workers[i]->nLoggers.load() < m_workers[workerIndex]->nLoggers.load()){
+                workerIndex = i;
+            }
+        }
+        m_workers[workerIndex]->nLoggers.fetch_add(1);
+
+        logger->m_worker.store(workerIndex, std::memory_order_relaxed);
+        logger->m_wakeThreshold.store(wakeThreshold(*logger), std::memory_order_relaxed);
+        logger->m_signal.store(&m_workers[workerIndex]->signal, std::memory_order_release);
+        logger->m_sink.setGroupCommit(true);
+        logger->m_isHandledByThreader.store(true, std::memory_order_release);
+
+        m_handledLoggers.push_back(logger);
+        m_loggersVersion.fetch_add(1, std::memory_order_release);
+    }
+
+    // maximal time an entry waits in queue before threader wakes up by itself (see constructor)
+    // also changes when producers of loggers already handled wake the threader; sleeping workers pick it up right away
+    void setMaxLatency(std::chrono::microseconds maxLatency){
+        m_maxLatency.store(maxLatency, std::memory_order_relaxed);
+        {
+            std::lock_guard<std::mutex> lock(m_loggersMutex);
+            for(const std::shared_ptr<Logger>& logger : m_handledLoggers){
+                logger->m_wakeThreshold.store(wakeThreshold(*logger), std::memory_order_relaxed);
+            }
+        }
+        for(auto& worker : m_workers){
+            worker->signal.wake();
+        }
+    }
+
+    // after being woken up, threader waits this long before draining, so that bursts get written in fewer batches
+    void setCoalescingWindow(std::chrono::microseconds window){
+        m_coalescingWindow.store(window, std::memory_order_relaxed);
+    }
+
+    // maximal amount of entries handled per logger before moving on to next one
+    // a logger with more than this amount of queued entries counts as backlogged and may be taken over by an idle worker
+    void setBatchSize(std::size_t batchSize){
+        m_batchSize.store(batchSize > 0 ? batchSize : 1, std::memory_order_relaxed);
+    }
+
+    // pins all worker threads to given cpus (e.g. to keep logging away from real-time cores); returns false on failure
+    bool setCpuAffinity(const std::vector<int>& cpus){
+        #ifdef __linux__
+        cpu_set_t cpuSet;
+        CPU_ZERO(&cpuSet);
+        for(int cpu : cpus){
+            CPU_SET(cpu, &cpuSet);
+        }
+
+        bool success = true;
+        for(auto& worker : m_workers){
+            if(pthread_setaffinity_np(worker->thread.native_handle(), sizeof(cpuSet), &cpuSet) != 0){
+                success = false;
+            }
+        }
+        return success;
+        #else
+        (void)cpus;
+        return false;
+        #endif
+    }
+
+    std::size_t getWorkerCount() const { return m_workers.size(); }
+
+    // amount of loggers taken over by idle workers so far
+    std::uint64_t getStealCount() const { return m_steals.load(std::memory_order_relaxed); }
+
+    LogThreaderStats getStats(){
+        LogThreaderStats stats;
+        stats.workers = m_workers.size();
+        for(auto& worker : m_workers){
+            stats.written += worker->written.load(std::memory_order_relaxed);
+            stats.rounds += worker->rounds.load(std::memory_order_relaxed);
+            stats.wakeups += worker->wakeups.load(std::memory_order_relaxed);
+        }
+        stats.steals = getStealCount();
+
+        std::lock_guard<std::mutex> lock(m_loggersMutex);
+        stats.loggers = m_handledLoggers.size();
+        return stats;
+    }
+
+    // writes stats of threader and all its loggers into target every interval (0 -> no reports)
+    // target may be handled by this threader too; a report is skipped if target's queue is half full
+    void setSelfReport(std::shared_ptr<TextLogger> target, std::chrono::seconds interval){
+        std::lock_guard<std::mutex> lock(m_reportMutex);
+        m_reportTarget = target;
+        m_reportInterval = interval;
+        m_nextReport = std::chrono::steady_clock::now() + interval;
+        m_isReporting.store(target != nullptr && interval.count() > 0, std::memory_order_release);
+    }
+
+private:
+    struct Worker{
+        std::thread thread;
+        LogSignal signal;                           // producers of loggers assigned to this worker wake it through this
+        std::atomic<std::size_t> nLoggers{0};       // amount of loggers assigned to this worker
+
+        // stats, only written by worker itself
+        std::atomic<std::uint64_t> written{0};
+        std::atomic<std::uint64_t> rounds{0};
+        std::atomic<std::uint64_t> wakeups{0};
+    };
+
+    static void count(std::atomic<std::uint64_t>& counter, std::uint64_t n=1){
+        counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+
+    // with a maximal latency, producers only wake the threader once a queue is half full
+    std::size_t wakeThreshold(const Logger& logger) const {
+        return m_maxLatency.load(std::memory_order_relaxed).count() > 0 ? logger.m_logEntries->capacity() / 2 : 1;
+    }
+
+    // self report is done by first worker
+    void reportIfDue(const std::vector<std::shared_ptr<Logger>>& loggers){
+        if(!m_isReporting.load(std::memory_order_acquire)){
+            return;
+        }
+
+        std::shared_ptr<TextLogger> target;
+        {
+            std::lock_guard<std::mutex> lock(m_reportMutex);
+            std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+            if(!m_reportTarget || now < m_nextReport){
+                return;
+            }
+            m_nextReport = now + m_reportInterval;
+            target = m_reportTarget;
+        }
+
+        // don't block on (or flood) a queue which might be drained by this very worker
+        if((std::size_t)target->getQueueSize() > target->m_logEntries->capacity() / 2){
+            return;
+        }
+
+        LogThreaderStats threaderStats = getStats();
+        target->log("LogThreader stats: workers=" + std::to_string(threaderStats.workers) + " loggers=" + std::to_string(threaderStats.loggers)
+                    + " written=" + std::to_string(threaderStats.written) + " rounds=" + std::to_string(threaderStats.rounds)
+                    + " wakeups=" + std::to_string(threaderStats.wakeups) + " steals=" + std::to_string(threaderStats.steals), LogLevel::Info);
+
+        for(const std::shared_ptr<Logger>& logger : loggers){
+            LoggerStats stats = logger->getStats();
+            std::string msg = "Logger stats " + logger->m_logFilePath + ": enqueued=" + std::to_string(stats.enqueued)
+                              + " written=" + std::to_string(stats.written) + " depth=" + std::to_string(stats.queueDepth)
+                              + " highWater=" + std::to_string(stats.queueHighWater)
+                              + " dropped=" + std::to_string(stats.droppedNewest) + "/" + std::to_string(stats.droppedOldest)
+                              + " bytes=" + std::to_string(stats.sink.bytes) + " syscalls=" + std::to_string(stats.sink.syscalls)
+                              + " flushes=" + std::to_string(stats.sink.flushes);
+            if(stats.endToEndLatency.count() > 0){
+                msg += " enqueue_ns(p50/p99/max)=" + std::to_string(stats.enqueueLatency.percentile(0.5)) + "/" + std::to_string(stats.enqueueLatency.percentile(0.99)) + "/" + std::to_string(stats.enqueueLatency.max())
+                     + " e2e_ns(p50/p99/max)=" + std::to_string(stats.endToEndLatency.percentile(0.5)) + "/" + std::to_string(stats.endToEndLatency.percentile(0.99)) + "/" + std::to_string(stats.endToEndLatency.max());
+            }
+            target->log(msg, LogLevel::Info);
+        }
+    }
+
+    // runs in worker threads; writes entries of assigned queues to file and/or console, sleeps while there is nothing to do
+    void logging(std::size_t workerIndex){
+
+        consoleMutex.lock();
+        std::cout << "LogThreader INFO: logging on thread id " << std::this_thread::get_id() << std::endl;
+        consoleMutex.unlock();
+
+        Worker& worker = *m_workers[workerIndex];
+
+        std::vector<std::shared_ptr<Logger>> loggers;     // local copy, so that addLogger doesn't need to wait for a whole round
+        unsigned int loggersVersion = 0;
+
+        while(true){
+            bool canExit = !m_loggerRunning;    // if logger is still running, no chance for exit
+
+            if(m_loggersVersion.load(std::memory_order_acquire) != loggersVersion){
+                std::lock_guard<std::mutex> lock(m_loggersMutex);
+                loggers = m_handledLoggers;
+                loggersVersion = m_loggersVersion.load(std::memory_order_relaxed);
+            }
+
+            if(workerIndex == 0){
+                reportIfDue(loggers);
+            }
+
+            // handle up to one batch per assigned queue per round, so that every logger gets processed equally
+            count(worker.rounds);
+            bool didWork = false;
+            bool isBacklogged = false;
+            bool isCommitPending = false;       // asynchronous output: flush or sync requests wait for completions
+            for(std::size_t i = 0; i < loggers.size(); ++i){
+                Logger& logger = *loggers[i];
+                if(logger.m_worker.load(std::memory_order_acquire) != workerIndex || !claim(logger)){
+                    continue;
+                }
+
+                // logger might have been taken over between check and claim
+                std::size_t count = 0;
+                if(logger.m_worker.load(std::memory_order_acquire) == workerIndex){
+                    count = drainBatch(logger);
+                    isCommitPending = isCommitPending || logger.m_sink.hasPendingCommits();
+                }
+                release(logger);
+
+                if(count > 0){
+                    didWork = true;
+                    LogThreader::count(worker.written, count);
+                }
+                if(count == m_batchSize.load(std::memory_order_relaxed)){
+                    isBacklogged = true;
+                }
+            }
+
+            // let idle workers take some of the load
+            if(isBacklogged && worker.nLoggers.load(std::memory_order_relaxed) > 1 && m_idleWorkers.load(std::memory_order_relaxed) > 0){
+                for(std::size_t i = 0; i < m_workers.size(); ++i){
+                    if(i != workerIndex){
+                        m_workers[i]->signal.wake();
+                    }
+                }
+            }
+
+            if(didWork){
+                continue;
+            }
+
+            if(steal(workerIndex, loggers)){
+                continue;
+            }
+
+            // all assigned queues were empty during a whole round
+            if(canExit){
+                break;
+            }
+
+            std::chrono::microseconds maxLatency = m_maxLatency.load(std::memory_order_relaxed);
+            std::chrono::microseconds timeout = maxLatency.count() > 0 ? maxLatency : std::chrono::microseconds(100000);
+            if(isCommitPending){
+                timeout = std::min(timeout, std::chrono::microseconds(100));
+            }
+            m_idleWorkers.fetch_add(1, std::memory_order_relaxed);
+            worker.signal.wait(timeout, [&]{
+                if(!m_loggerRunning) return true;
+                for(std::size_t i = 0; i < loggers.size(); ++i){
+                    if(loggers[i]->m_worker.load(std::memory_order_relaxed) == workerIndex && loggers[i]->getQueueSize() > 0) return true;
+                }
+                return false;
+            });
+            m_idleWorkers.fetch_sub(1, std::memory_order_relaxed);
+            count(worker.wakeups);
+
+            // time based flushing of buffered file output and summaries of floods which have stopped
+            for(std::size_t i = 0; i < loggers.size(); ++i){
+                Logger& logger = *loggers[i];
+                if(logger.m_worker.load(std::memory_order_acquire) != workerIndex){
+                    continue;
+                }
+                logger.reportPendingSuppressed(false);
+                if(claim(logger)){
+                    logger.m_sink.flushIfDue();
+                    release(logger);
+                }
+            }
+
+            std::chrono::microseconds coalescingWindow = m_coalescingWindow.load(std::memory_order_relaxed);
+            if(coalescingWindow.count() > 0 && m_loggerRunning){
+                std::this_thread::sleep_for(coalescingWindow);
+            }
+        }
+    }
+
+    // takes over the most backlogged logger of a worker which has more than one logger; returns true if one was taken
+    bool steal(std::size_t workerIndex, const std::vector<std::shared_ptr<Logger>>& loggers){
+        if(m_workers.size() < 2){
+            return false;
+        }
+
+        Logger* victim = nullptr;
+        std::size_t victimSize = m_batchSize.load(std::memory_order_relaxed);
+        for(std::size_t i = 0; i < loggers.size(); ++i){
+            std::size_t owner = loggers[i]->m_worker.load(std::memory_order_relaxed);
+            std::size_t queueSize = loggers[i]->getQueueSize();
+            if(owner != workerIndex && queueSize > victimSize && m_workers[owner]->nLoggers.load(std::memory_order_relaxed) > 1){
+                victim = loggers[i].get();
+                victimSize = queueSize;
+            }
+        }
+        if(victim == nullptr){
+            return false;
+        }
+
+        // owner may change while we look at it; only take logger if it is still where we found it
+        std::size_t owner = victim->m_worker.load(std::memory_order_relaxed);
+        if(owner == workerIndex || !victim->m_worker.compare_exchange_strong(owner, workerIndex, std::memory_order_acq_rel)){
+            return false;
+        }
+        m_workers[owner]->nLoggers.fetch_sub(1, std::memory_order_relaxed);
+        m_workers[workerIndex]->nLoggers.fetch_add(1, std::memory_order_relaxed);
+        victim->m_signal.store(&m_workers[workerIndex]->signal, std::memory_order_release);
+        m_steals.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // only one worker at a time may write entries of a logger (keeps order in file)
+    bool claim(Logger& logger){
+        return !logger.m_draining.exchange(true, std::memory_order_acquire);
+    }
+
+    void release(Logger& logger){
+        logger.m_draining.store(false, std::memory_order_release);
+    }
+
+    // writes up to m_batchSize entries of logger's queue; returns amount of written entries
+    std::size_t drainBatch(Logger& logger){
+        std::size_t count = 0;
+        std::size_t batchSize = m_batchSize.load(std::memory_order_relaxed);
+        while(count < batchSize){
+            LogEntryPtr entry = logger.getQueueItem();
+            if(!entry){
+                break;
+            }
+
+            // write to console and/or file
+            std::uint64_t queuedAt = entry->getQueuedAt();
+            logger.writeEntry(move(entry));
+            logger.countWritten(queuedAt);
+            ++count;
+        }
+
+        // flush and sync requests of the batch (barriers, entries with syncLevel) share one fdatasync
+        logger.m_sink.commit();
+        return count;
+    }
+
+    std::atomic<bool> m_loggerRunning;      // is set to true by constructor and to false by destructor; keeps logging() function running 
+
+    std::vector<std::unique_ptr<Worker>> m_workers;     // started in constructor, joined in destructor
+    std::atomic<std::size_t> m_idleWorkers{0};          // workers currently waiting for entries
+    std::atomic<std::uint64_t> m_steals{0};
+
+    // settings may be changed while workers run
+    std::atomic<std::chrono::microseconds> m_maxLatency{std::chrono::microseconds(0)};
+    std::atomic<std::chrono::microseconds> m_coalescingWindow{std::chrono::microseconds(0)};
+    std::atomic<std::size_t> m_batchSize{256};
+
+    std::mutex m_reportMutex;               // guards self report settings
+    std::shared_ptr<TextLogger> m_reportTarget;
+    std::chrono::seconds m_reportInterval{0};
+    std::chrono::steady_clock::time_point m_nextReport;
+    std::atomic<bool> m_isReporting{false};
+
+    std::mutex m_loggersMutex;              // guards m_handledLoggers against addLogger while logging threads copy it
+    std::atomic<unsigned int> m_loggersVersion{0};
+    std::vector<std::shared_ptr<Logger>> m_handledLoggers;
+};
+#endif
+
+#ifdef __linux__
+/* Saves queued and buffered entries of all loggers when the process dies (fatal signal or std::terminate),
+ * so that loggers can use buffered output (FlushPolicy) without losing the entries leading up to a crash
+ * - files are written with write/writev only, no locks are taken (console output is skipped)
+ * - a logger currently written by a LogThreader worker is taken over after claimTimeout (worker may be wedged)
+ * - watchdog: if draining doesn't finish within deadline (e.g. heap is corrupted), process is terminated anyway
+ * queued entries still have to be formatted; this happens in buffers of recycled entries, which usually don't
+ * need to grow, but a guarantee is not possible (that is what the watchdog is for)
+ * afterwards the signal is passed on to previously installed handler (or default action, i.e. core dump) */
+class LogCrashHandler{
+public:
+    // installs handlers for SIGSEGV, SIGABRT, SIGBUS, SIGFPE, SIGILL and std::terminate
+    // also sets up an alternate signal stack for calling thread, so that stack overflows of it can be handled
+    static bool install(std::chrono::milliseconds claimTimeout = std::chrono::milliseconds(200), std::chrono::seconds deadline = std::chrono::seconds(3)){
+        if(s_isInstalled.exchange(true)){
+            return false;
+        }
+        s_claimTimeoutNs = (std::int64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(claimTimeout).count();
+        s_deadlineSeconds = (unsigned int)std::max<std::int64_t>(deadline.count(), 1);
+
+        static char altStack[64 << 10];
+        stack_t stack{};
+        stack.ss_sp = altStack;
+        stack.ss_size = sizeof(altStack);
+        sigaltstack(&stack, nullptr);
+
+        // handler is reset to previous one on entry (nested faults while draining terminate right away)
+        struct sigaction action{};
+        action.sa_handler = onSignal;
+        action.sa_flags = SA_ONSTACK | SA_NODEFER | SA_RESETHAND;
+        sigemptyset(&action.sa_mask);
+        for(std::size_t i = 0; i < s_nSignals; ++i){
+            sigaction(s_signals[i], &action, &s_previous[i]);
+        }
+        s_previousTerminate = std::set_terminate(onTerminate);
+        return true;
+    }
+
+    static void uninstall(){
+        if(!s_isInstalled.exchange(false)){
+            return;
+        }
+        for(std::size_t i = 0; i < s_nSignals; ++i){
+            sigaction(s_signals[i], &s_previous[i], nullptr);
+        }
+        std::set_terminate(s_previousTerminate);
+    }
+
+    // writes everything queued and buffered by all loggers; returns amount of queued entries written
+    // used by handlers, but may also be called right before process ends abnormally (e.g. before _exit)
+    // afterwards all file output is unbuffered
+    static std::size_t drainAll(){
+        LogCrashRegistry::s_isCrashing.store(true, std::memory_order_relaxed);
+        std::size_t count = 0;
+        for(std::atomic<Logger*>& slot : LogCrashRegistry::s_loggers){
+            Logger* logger = slot.load(std::memory_order_acquire);
+            if(logger != nullptr){
+                count += drain(*logger);
+            }
+        }
+        return count;
+    }
+
+private:
+    static constexpr int s_signals[] = {SIGSEGV, SIGABRT, SIGBUS, SIGFPE, SIGILL};
+    static constexpr std::size_t s_nSignals = sizeof(s_signals) / sizeof(s_signals[0]);
+
+    static void onSignal(int sig){
+        pid_t thread = (pid_t)syscall(SYS_gettid);
+        pid_t expected = 0;
+        if(!s_drainingThread.compare_exchange_strong(expected, thread)){
+            if(expected != thread){
+                // other thread crashed too: wait until drain is done (process is terminated by draining thread or watchdog)
+                while(true){
+                    pause();
+                }
+            }
+            // crashed again while draining (or abort after terminate handler): nothing more to save
+            passOn(sig);
+            return;
+        }
+
+        s_signal = sig;
+        startWatchdog();
+        writeStderr("Logger: fatal signal ", sig, ", writing pending log entries\n");
+        std::size_t count = drainAll();
+        writeStderr("Logger: ", (long)count, " queued entries written\n");
+        alarm(0);
+        passOn(sig);
+    }
+
+    static void onTerminate(){
+        pid_t expected = 0;
+        if(s_drainingThread.compare_exchange_strong(expected, (pid_t)syscall(SYS_gettid))){
+            s_signal = SIGABRT;
+            startWatchdog();
+            writeStderr("Logger: std::terminate called, writing pending log entries\n");
+            std::size_t count = drainAll();
+            writeStderr("Logger: ", (long)count, " queued entries written\n");
+            alarm(0);
+        }
+        if(s_previousTerminate != nullptr){
+            s_previousTerminate();
+        }
+        std::abort();
+    }
+
+    // watchdog: draining took too long, terminate with signal which caused the crash
+    static void onAlarm(int){
+        writeStderr("Logger: writing pending log entries did not finish in time\n");
+        signal(s_signal, SIG_DFL);
+        raise(s_signal);
+        _exit(128 + s_signal);
+    }
+
+    static void startWatchdog(){
+        struct sigaction action{};
+        action.sa_handler = onAlarm;
+        sigemptyset(&action.sa_mask);
+        sigaction(SIGALRM, &action, nullptr);
+        alarm(s_deadlineSeconds);
+    }
+
+    // hands signal over to handler installed before ours (or default action)
+    static void passOn(int sig){
+        for(std::size_t i = 0; i < s_nSignals; ++i){
+            if(s_signals[i] == sig){
+                sigaction(sig, &s_previous[i], nullptr);
+            }
+        }
+        raise(sig);
+        // previous handler returned: for faults, returning re-executes the faulting instruction, which calls it again
+    }
+
+    static std::size_t drain(Logger& logger){
+        std::size_t count = 0;
+        bool isClaimed = claim(logger);
+
+        // buffered data is older than anything still queued
+        logger.emergencyFlush();
+
+        #if ENABLE_MULTITHREADING
+        // don't loop forever if other threads keep on logging
+        std::size_t limit = logger.m_logEntries->capacity();
+        LogEntryPtr entry;
+        while(count < limit && logger.m_logEntries->pop(entry)){
+            logger.writeEntry(std::move(entry));
+            ++count;
+        }
+
+        // per-thread buffers are drained one after another (order between threads gets lost)
+        if(logger.m_useThreadBuffers.load(std::memory_order_acquire) && logger.m_threadBuffersMutex.try_lock()){
+            for(std::shared_ptr<LogThreadBuffer>& buffer : logger.m_threadBuffers){
+                std::size_t n = 0;
+                while(n++ < buffer->ring.capacity()){
+                    LogThreadBuffer::Item* item = buffer->ring.front();
+                    if(item == nullptr){
+                        break;
+                    }
+                    entry = std::move(item->entry);
+                    buffer->ring.popFront();
+                    logger.writeEntry(std::move(entry));
+                    ++count;
+                }
+            }
+            logger.m_threadBuffersMutex.unlock();
+        }
+        #endif
+
+        logger.emergencyFlush();
+
+        #if ENABLE_MULTITHREADING
+        if(isClaimed){
+            logger.m_draining.store(false, std::memory_order_release);
+        }
+        #endif
+        (void)isClaimed;
+        return count;
+    }
+
+    // waits until no LogThreader worker writes the logger anymore; false if worker didn't finish within claimTimeout
+    // (e.g. it is wedged or it is the crashed thread), logger is drained nevertheless then
+    static bool claim(Logger& logger){
+        #if ENABLE_MULTITHREADING
+        std::int64_t start = monotonicNs();
+        while(logger.m_draining.exchange(true, std::memory_order_acquire)){
+            if(monotonicNs() - start >= s_claimTimeoutNs){
+                return false;
+            }
+            struct timespec pause{0, 1000000};
+            nanosleep(&pause, nullptr);
+        }
+        return true;
+        #else
+        (void)logger;
+        return false;
+        #endif
+    }
+
+    static std::int64_t monotonicNs(){
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return (std::int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+    }
+
+    // stderr output without stdio (not async-signal-safe)
+    static void writeStderr(const char* text){
+        std::size_t len = strlen(text);
+        while(len > 0){
+            ssize_t written = ::write(STDERR_FILENO, text, len);
+            if(written <= 0){
+                if(written < 0 && errno == EINTR) continue;
+                return;
+            }
+            text += written;
+            len -= (std::size_t)written;
+        }
+    }
+
+    static void writeStderr(const char* before, long number, const char* after){
+        char buffer[24];
+        std::to_chars_result result = std::to_chars(buffer, buffer + sizeof(buffer) - 1, number);
+        *result.ptr = '\0';
+        writeStderr(before);
+        writeStderr(buffer);
+        writeStderr(after);
+    }
+
+    inline static std::atomic<bool> s_isInstalled{false};
+    inline static std::atomic<pid_t> s_drainingThread{0};     // thread which handles the crash
+    inline static volatile sig_atomic_t s_signal = SIGABRT;
+    inline static std::int64_t s_claimTimeoutNs = 200000000;
+    inline static unsigned int s_deadlineSeconds = 3;
+    inline static struct sigaction s_previous[s_nSignals];
+    inline static std::terminate_handler s_previousTerminate = nullptr;
+};
+#endif
+
+#ifdef __linux__
+/* Ring of one SharedTextLogger in POSIX shared memory (segment "/<channel>.<pid>.<n>", see LogShmWriter)
+ * same scheme as LogRing (every slot carries a sequence number): producers are the threads of the client process,
+ * the only consumer is the writer process; an entry which doesn't fit into one slot takes several consecutive
+ * ones, which are claimed at once and published first slot last (a published first slot means a complete entry)
+ * the client holds a shared flock on the segment as long as it lives, so the writer notices when it is gone
+ * (also if it crashed) and can skip slots which have been claimed but never published */
+class LogShmRing{
+public:
+    static constexpr char s_magic[8] = {'L', 'O', 'G', 'S', 'H', 'M', '0', '1'};
+    static constexpr std::size_t s_maxPath = 4096;
+
+    enum State : std::uint32_t {
+        Initializing = 0,
+        Ready = 1,
+        Closed = 2          // client has shut down its logger; writer drains what is left and removes segment
+    };
+
+    struct Slot{
+        std::atomic<std::uint64_t> seq;
+        std::int64_t timeNs;
+        std::uint32_t len;          // first slot: length of message, continuation: bytes in this slot
+        std::uint16_t nSlots;       // first slot: slots taken by entry; 0 -> continuation
+        std::uint8_t level;
+        std::uint8_t reserved;
+        // followed by message bytes
+    };
+    static_assert(sizeof(Slot) == 24, "unexpected padding in shared memory slot");
+    static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "atomics in shared memory have to be lock free");
+
+    struct Header{
+        char magic[8];
+        std::atomic<std::uint32_t> state;
+        std::uint32_t slotSize;                             // bytes per slot (including Slot)
+        std::uint64_t capacity;                             // slots (power of two)
+        std::int64_t pid;                                   // client process
+        char path[s_maxPath];                               // absolute path of log file
+        alignas(64) std::atomic<std::uint64_t> enqueuePos;  // written by clients
+        alignas(64) std::atomic<std::uint64_t> dequeuePos;  // written by writer
+        alignas(64) std::atomic<std::uint64_t> dropped;     // entries the client discarded because ring was full
+    };
+
+    static std::size_t segmentSize(std::size_t capacity, std::size_t slotSize){
+        return sizeof(Header) + capacity * slotSize;
+    }
+
+    // client: sets up ring in a new segment; writer only looks at it after state has been set to Ready
+    void init(void* base, std::size_t capacity, std::size_t slotSize, const std::string& path){
+        Header* header = new (base) Header();
+        std::memcpy(header->magic, s_magic, sizeof(s_magic));
+        header->slotSize = (std::uint32_t)slotSize;
+        header->capacity = capacity;
+        header->pid = (std::int64_t)::getpid();
+        std::memcpy(header->path, path.c_str(), std::min(path.size() + 1, s_maxPath));
+        header->path[s_maxPath - 1] = '\0';
+        setLayout(base, capacity, slotSize);
+
+        for(std::uint64_t i = 0; i < capacity; ++i){
+            Slot* s = new (m_slots + i * slotSize) Slot();
+            s->seq.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    // writer: checks segment written by a client; false if it is not (yet) a complete ring
+    bool attach(void* base, std::size_t size){
+        if(size < sizeof(Header)){
+            return false;
+        }
+        Header* header = (Header*)base;
+        if(header->state.load(std::memory_order_acquire) == Initializing || std::memcmp(header->magic, s_magic, sizeof(s_magic)) != 0){
+            return false;
+        }
+        std::uint64_t capacity = header->capacity;
+        std::uint32_t slotSize = header->slotSize;
+        if(capacity < 2 || (capacity & (capacity - 1)) != 0 || slotSize < 64 || slotSize % 64 != 0
+           || capacity > (size - sizeof(Header)) / slotSize || size != segmentSize(capacity, slotSize)){
+            return false;
+        }
+        if(std::memchr(header->path, '\0', s_maxPath) == nullptr){
+            return false;
+        }
+        setLayout(base, capacity, slotSize);
+        return true;
+    }
+
+    Header& header(){ return *m_header; }
+
+    // longest message an entry can hold (longer ones get cut by the client)
+    std::size_t maxMessageSize() const { return maxSlots() * m_dataSize; }
+
+    // client: copies entry into ring; returns false if ring is full (msg has to fit, see maxMessageSize)
+    bool tryPush(std::string_view msg, LogLevel logLevel, std::int64_t timeNs){
+        std::uint64_t nSlots = msg.size() <= m_dataSize ? 1 : (msg.size() + m_dataSize - 1) / m_dataSize;
+        std::uint64_t pos = m_header->enqueuePos.load(std::memory_order_relaxed);
+
+        while(true){
+            std::int64_t diff = (std::int64_t)(slot(pos)->seq.load(std::memory_order_acquire) - pos);
+            if(diff == 0){
+                // writer frees slots in order, so if the last one is free, all in between are as well
+                std::uint64_t last = pos + nSlots - 1;
+                std::int64_t lastDiff = (std::int64_t)(slot(last)->seq.load(std::memory_order_acquire) - last);
+                if(lastDiff < 0){
+                    return false;   // full
+                }
+                if(lastDiff == 0){
+                    if(m_header->enqueuePos.compare_exchange_weak(pos, pos + nSlots, std::memory_order_relaxed)) break;
+                    continue;
+                }
+            }
+            else if(diff < 0){
+                return false;       // full
+            }
+            pos = m_header->enqueuePos.load(std::memory_order_relaxed);
+        }
+
+        const char* data = msg.data();
+        std::size_t left = msg.size();
+        for(std::uint64_t i = 0; i < nSlots; ++i){
+            Slot* s = slot(pos + i);
+            std::size_t len = std::min(left, m_dataSize);
+            std::memcpy(payload(s), data, len);
+            data += len;
+            left -= len;
+            s->timeNs = timeNs;
+            s->len = i == 0 ? (std::uint32_t)msg.size() : (std::uint32_t)len;
+            s->nSlots = i == 0 ? (std::uint16_t)nSlots : 0;
+            s->level = (std::uint8_t)logLevel;
+        }
+
+        // continuation slots first, so that writer never sees a published entry with missing parts
+        for(std::uint64_t i = nSlots - 1; i > 0; --i){
+            slot(pos + i)->seq.store(pos + i + 1, std::memory_order_release);
+        }
+        slot(pos)->seq.store(pos + 1, std::memory_order_release);
+        return true;
+    }
 
-/* Derived Logger class to represend log-entries in normal text log */
-class LogEntryText : public LogEntry{
-public:
-    LogEntryText(LogLevel logLevel,
-                 std::string msg,
-                 std::string customTimeStr = "",
-                 time_t rawTime = 0)
-        :m_logLevel(logLevel), m_msg(msg), m_customTimeStr(customTimeStr), m_rawTime(rawTime)
-    {}
-    
-    void constructEntry() override{
+    // writer: first slot of oldest entry (time stamp and level), nullptr if there is no complete one
+    // published slots which don't start a valid entry are skipped (continuations of entries skipped by skipClaimed)
+    const Slot* front(){
+        while(true){
+            std::uint64_t pos = m_header->dequeuePos.load(std::memory_order_relaxed);
+            Slot* first = slot(pos);
+            std::uint64_t seq = first->seq.load(std::memory_order_acquire);
+
+            // previous writer died while freeing this entry's slots
+            if(seq == pos + m_capacity){
+                m_header->dequeuePos.store(pos + 1, std::memory_order_release);
+                continue;
+            }
+            if(seq != pos + 1){
+                return nullptr;
+            }
 
-        m_entry = m_msg;
+            std::uint64_t nSlots = first->nSlots;
+            if(nSlots >= 1 && nSlots <= maxSlots() && first->len <= nSlots * m_dataSize && isPublished(pos, nSlots)){
+                return first;
+            }
+            if(nSlots != 0){
+                ++m_lost;
+            }
+            release(pos, 1);
+        }
+    }
 
-        // add logLevel as string at front
-        addLogLevel(m_entry);
+    // writer: copies message of entry returned by front()
+    void read(const Slot* first, std::string& msg){
+        std::uint64_t pos = m_header->dequeuePos.load(std::memory_order_relaxed);
+        std::size_t left = first->len;
+        msg.clear();
+        for(std::uint64_t i = 0; left > 0; ++i){
+            std::size_t len = std::min(left, m_dataSize);
+            msg.append(payload(slot(pos + i)), len);
+            left -= len;
+        }
+    }
 
-        // add time as string at front
-        addTime(m_entry);
+    // writer: frees slots of entry returned by front()
+    void popFront(){
+        std::uint64_t pos = m_header->dequeuePos.load(std::memory_order_relaxed);
+        release(pos, slot(pos)->nSlots);
     }
 
-private:
-    // adds log Level as string in front of message
-    void addLogLevel(std::string& msg){
+    // writer, client is gone: skips slots at front which have been claimed but will never be published
+    // (client died while writing an entry); returns false if there was nothing to skip
+    bool skipClaimed(){
+        std::uint64_t pos = m_header->dequeuePos.load(std::memory_order_relaxed);
+        std::uint64_t end = m_header->enqueuePos.load(std::memory_order_acquire);
+        if(pos >= end || slot(pos)->seq.load(std::memory_order_acquire) == pos + 1){
+            return false;
+        }
+        while(pos < end && slot(pos)->seq.load(std::memory_order_acquire) != pos + 1){
+            release(pos, 1);
+            ++pos;
+        }
+        ++m_lost;
+        return true;
+    }
 
-        // create empty string and write LogLevel into it
-        std::string levelStr = "";
-        logLevelToStr(levelStr, m_logLevel);
+    bool isEmpty() const {
+        return m_header->dequeuePos.load(std::memory_order_acquire) >= m_header->enqueuePos.load(std::memory_order_acquire);
+    }
 
-        // add colon
-        levelStr += ":";
+    // approximate amount of slots in use
+    std::size_t size() const {
+        std::uint64_t enq = m_header->enqueuePos.load(std::memory_order_acquire);
+        std::uint64_t deq = m_header->dequeuePos.load(std::memory_order_acquire);
+        return enq > deq ? (std::size_t)(enq - deq) : 0;
+    }
 
-        // all log entries should have same length, so fill up space
-        // TODO does not work properly for Warnings
-        for(int i = 0; i < 12-levelStr.length(); ++i){
-            levelStr += " ";
-        }
+    // entries skipped by this writer because they were incomplete
+    std::uint64_t getLost() const { return m_lost; }
 
-        // combine everything
-        msg = levelStr + msg;
+private:
+    void setLayout(void* base, std::size_t capacity, std::size_t slotSize){
+        m_header = (Header*)base;
+        m_slots = (char*)base + sizeof(Header);
+        m_capacity = capacity;
+        m_mask = capacity - 1;
+        m_slotSize = slotSize;
+        m_dataSize = slotSize - sizeof(Slot);
     }
 
-    // adds time as string in front of message
-    void addTime(std::string& msg){
+    Slot* slot(std::uint64_t pos) const { return (Slot*)(m_slots + (pos & m_mask) * m_slotSize); }
 
-        // custom time
-        std::string customTimeStr = "";
-        if(m_customTimeStr != ""){
-            // TODO format
-            if(m_customTimeStr != " "){
-                msg = m_customTimeStr + " - " + msg;
+    static char* payload(Slot* s){ return (char*)s + sizeof(Slot); }
+
+    std::uint64_t maxSlots() const { return std::min<std::uint64_t>(m_capacity / 2, 0xFFFF); }
+
+    bool isPublished(std::uint64_t pos, std::uint64_t nSlots) const {
+        for(std::uint64_t i = 1; i < nSlots; ++i){
+            Slot* s = slot(pos + i);
+            if(s->seq.load(std::memory_order_acquire) != pos + i + 1 || s->nSlots != 0){
+                return false;
             }
         }
-        else{
-            // real time
-            std::string rawTimeStr = "";
-            if(m_rawTime == 0){
-                time(&m_rawTime);
-            }
-            struct tm * timeinfo;
-            char buffer[80];
-            timeinfo = localtime(&m_rawTime);
+        return true;
+    }
 
-            strftime(buffer,sizeof(buffer),"%d-%m-%Y %H:%M:%S",timeinfo);
-            rawTimeStr = std::string(buffer);
-            // TODO format
-            msg = rawTimeStr + " - " + msg;
+    void release(std::uint64_t pos, std::uint64_t nSlots){
+        for(std::uint64_t i = 0; i < nSlots; ++i){
+            slot(pos + i)->seq.store(pos + i + m_capacity, std::memory_order_release);
         }
+        m_header->dequeuePos.store(pos + nSlots, std::memory_order_release);
     }
 
-    LogLevel m_logLevel;
-    std::string m_msg;
-    std::string m_customTimeStr = "";
-    time_t m_rawTime = 0;
+    Header* m_header = nullptr;
+    char* m_slots = nullptr;
+    std::uint64_t m_capacity = 0;
+    std::uint64_t m_mask = 0;
+    std::size_t m_slotSize = 0;
+    std::size_t m_dataSize = 0;
+    std::uint64_t m_lost = 0;
 };
 
-/* Derived Logger class to handle text logging (normal .log-files) */
-class TextLogger : public Logger{
+/* Text logger whose file output is done by another process: log calls only copy level, time and message into a
+ * lock-free ring in shared memory (LogShmRing), a writer process (LogShmWriter, e.g. ./build/logwriter) composes the
+ * lines and writes them; neither formatting of the line nor any file output happen in the logging process
+ * several processes (and several loggers of one process) may log into the same file, the writer merges them by time
+ * while no writer runs, entries are kept in the ring; if it is full, they are discarded (or log waits, see setOverflowPolicy) */
+class SharedTextLogger{
 public:
-    TextLogger(std::string logFileName, LogLevel newLogLevel, bool logFileNameIsAbsolutePath=false, bool enableConsolePrinting=false, bool useCustomTime=false)      // for normal text logs
-        :Logger(enableConsolePrinting), m_logLevel(newLogLevel), m_useCustomTime(useCustomTime)
+    // capacity: slots of ring; slotSize: bytes per slot (entries which don't fit take several slots)
+    SharedTextLogger(std::string logFileName, LogLevel newLogLevel, bool logFileNameIsAbsolutePath=false,
+                     const std::string& channel="logger", std::size_t capacity=16384, std::size_t slotSize=256)
+        :m_logLevel(newLogLevel)
     {
-        // if no specific logFileName provided, use default
+        // same file name rules as TextLogger, but path is resolved here as writer has another working directory
         if(logFileName == ""){
             logFileName = "log0.log";
         }
-
-        // if logfile has no file extension, add it
-        if(logFileName.substr(logFileName.size()-4, 4) != ".log"){
+        if(logFileName.size() < 4 || logFileName.substr(logFileName.size()-4, 4) != ".log"){
             logFileName += ".log";
         }
+        if(!logFileNameIsAbsolutePath){
+            char cwd[256];
+            if(getcwd(cwd, 256) == nullptr){
+                cwd[0] = '\0';
+            }
+            logFileName = std::string(cwd) + "/log/" + logFileName;
+        }
+        open(logFileName, channel, capacity, slotSize);
+    }
 
-        setup(logFileName, logFileNameIsAbsolutePath);
-
-        // check if passed log-level is valid (and get loglevel as string), else return
-        std::string levelStr = "";
-        if(!logLevelToStr(levelStr, m_logLevel)){
-            std::string errMsg = "Undefined LogLevel. Logger is terminating.";
-            std::unique_ptr<LogEntryText> entry = std::make_unique<LogEntryText>(LogLevel::Error, errMsg, "", 0);
-            print(move(entry));
+    ~SharedTextLogger(){
+        if(m_base == nullptr){
             return;
         }
+        // writer drains what is left and removes the segment
+        m_ring.header().state.store(LogShmRing::Closed, std::memory_order_release);
+        ::munmap(m_base, m_size);
+        ::close(m_fd);     // releases flock
+    }
 
-        std::string initMsg = "Starting logger with log level " + levelStr;
-        std::unique_ptr<LogEntryText> entry = std::make_unique<LogEntryText>(LogLevel::Info, initMsg, "", 0);
-        print(move(entry));
-        
+    SharedTextLogger(const SharedTextLogger&) = delete;
+    SharedTextLogger& operator=(const SharedTextLogger&) = delete;
+
+    // hands entry over to writer (messages longer than the ring allows get cut)
+    void log(std::string_view logEntry, LogLevel logLevel){
+        if(isEnabled(logLevel)){
+            write(logEntry, logLevel);
+        }
     }
 
-    ~TextLogger(){
-        std::string infoMsg = "TextLogger has been shut down";
-        
-        std::unique_ptr<LogEntryText> entry = std::make_unique<LogEntryText>(LogLevel::Info, infoMsg, "", 0);
-        print(move(entry), true);
-        m_logFile << "------------------------------------------\n\n";
+    // wrapper for above method
+    void log(const char* logEntry, LogLevel logLevel){
+        log(std::string_view(logEntry), logLevel);
     }
 
-    // create log entries
-    // write entries to m_logEntries
-    void log(const std::string &logEntry, LogLevel logLevel, std::string timeStr = ""){
-    
-        if(logLevel <= m_logLevel) {
+    // level known at compile time (see TextLogger::log<Level>)
+    template<LogLevel Level>
+    void log(std::string_view logEntry){
+        if constexpr (Level <= LOGGER_COMPILE_LEVEL){
+            log(logEntry, Level);
+        }
+    }
 
-            time_t rawTime = 0;
-            if(!m_useCustomTime){
-                time (&rawTime);
+    // formatted logging (see TextLogger::log<Level>(fmt, args...)); the message is formatted in this process,
+    // time stamp and level are added by the writer (custom time strings are not supported and get ignored)
+    template<LogLevel Level, typename... Args>
+        requires (sizeof...(Args) > 0)
+    void log(LogFormatStringFor<Args...> fmt, const Args&... args){
+        if constexpr (Level <= LOGGER_COMPILE_LEVEL){
+            if(isEnabled(Level)){
+                if(!fmt.hasFields()){
+                    write(fmt.get(), Level);
+                    return;
+                }
+                thread_local std::string msg;
+                msg.clear();
+                LogFormat::format(msg, fmt.get(), args...);
+                write(msg, Level);
             }
+        }
+    }
 
-            std::unique_ptr<LogEntryText> entry = std::make_unique<LogEntryText>(logLevel, logEntry, timeStr, rawTime);
+    bool isEnabled(LogLevel logLevel) const {
+        return logLevel <= LOGGER_COMPILE_LEVEL && logLevel <= m_logLevel.load(std::memory_order_relaxed);
+    }
 
-            if(isHandledByThreader()){
-                #if ENABLE_MULTITHREADING
-                // write to queue
-                m_queueMutex.lock();
-                m_logEntries.push(move(entry));
-                m_queueMutex.unlock();
-                #endif
-            } else {
-                // write to log
-                print(move(entry));
-            }
+    void setLogLevel(LogLevel newLogLevel){
+        m_logLevel.store(newLogLevel, std::memory_order_relaxed);
+    }
+
+    // called by LOG_<LEVEL> macros; only limits of the call site itself apply (LOG_LIMITED)
+    bool allowCallSite(LogCallSite& site, LogLevel logLevel){
+        (void)logLevel;
+        const LogRateLimit* limit = site.getLimit();
+        if(limit == nullptr){
+            return true;
         }
+        LogCallSite::Summary summary;
+        bool isAllowed = site.allow(*limit, summary);
+        if(summary.suppressed > 0){
+            log(site.describe(summary), LogLevel::Warning);
+        }
+        return isAllowed;
     }
 
-    // wrapper for above method
-    void log(const char* logEntry, LogLevel logLevel, std::string timeStr = ""){
-        std::string msg(logEntry);  // convert char* to std::string
-        log(msg, logLevel, timeStr);
+    // Block: log waits until writer has made room (forever if no writer runs); everything else: entry is discarded
+    void setOverflowPolicy(QueueOverflowPolicy policy){
+        m_policy.store(policy, std::memory_order_relaxed);
     }
 
-    // allows to change loglevel after logger-construction. 
-    // e.g. to increase loglevel temporarely
-    void setLogLevel(LogLevel newLogLevel){
-        m_logLevel = newLogLevel;
+    // false if shared memory could not be set up (log calls do nothing then)
+    bool isOpen() const { return m_base != nullptr; }
+
+    // entries discarded because ring was full
+    std::uint64_t getDroppedCount(){
+        return m_base != nullptr ? m_ring.header().dropped.load(std::memory_order_relaxed) : 0;
     }
 
+    // approximate amount of slots waiting for writer
+    std::size_t getQueueSize() const { return m_base != nullptr ? m_ring.size() : 0; }
+
+    // name of shared memory segment ("/<channel>.<pid>.<n>")
+    const std::string& getSegmentName() const { return m_name; }
+
 private:
+    void open(const std::string& path, const std::string& channel, std::size_t capacity, std::size_t slotSize){
+        std::size_t size = 64;
+        while(size < capacity){
+            size <<= 1;
+        }
+        capacity = size;
+        slotSize = std::max<std::size_t>((slotSize + 63) / 64 * 64, 64);
 
-    LogLevel m_logLevel;
+        if(channel.empty() || channel.find('/') != std::string::npos || path.size() >= LogShmRing::s_maxPath){
+            printError("ERROR: invalid channel or log-file path for shared memory logging! " + path);
+            return;
+        }
 
-    bool m_useCustomTime;
+        m_name = "/" + channel + "." + std::to_string(::getpid()) + "." + std::to_string(s_nextId.fetch_add(1, std::memory_order_relaxed));
+        m_fd = ::shm_open(m_name.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+        if(m_fd < 0){
+            printError("ERROR: Could not create shared memory " + m_name + " (" + std::strerror(errno) + ")");
+            return;
+        }
 
-    // construct entry, give command to write to console and/or file
-    void print(std::unique_ptr<LogEntry> entry, bool enforceConsoleWriting=false) override{
+        // held until process ends, however it ends; writer takes this as sign of life
+        m_size = LogShmRing::segmentSize(capacity, slotSize);
+        void* base = MAP_FAILED;
+        if(::flock(m_fd, LOCK_SH) == 0 && ::ftruncate(m_fd, (off_t)m_size) == 0){
+            base = ::mmap(nullptr, m_size, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+        }
+        if(base == MAP_FAILED){
+            printError("ERROR: Could not map shared memory " + m_name + " (" + std::strerror(errno) + ")");
+            ::shm_unlink(m_name.c_str());
+            ::close(m_fd);
+            m_fd = -1;
+            return;
+        }
 
-        entry->constructEntry();
-        std::string msg = entry->getEntry();
+        m_base = base;
+        m_ring.init(m_base, capacity, slotSize, path);
+        m_ring.header().state.store(LogShmRing::Ready, std::memory_order_release);
+    }
 
-        // make entries at different locations
-        if(m_enableConsolePrinting || enforceConsoleWriting){
-            printToConsole(msg);
+    void write(std::string_view msg, LogLevel logLevel){
+        if(m_base == nullptr){
+            return;
+        }
+        msg = msg.substr(0, m_ring.maxMessageSize());
+        std::int64_t timeNs = LogTimeFormatter::nowNs();
+        if(m_ring.tryPush(msg, logLevel, timeNs)){
+            return;
         }
 
-        printToFile(msg);
+        if(m_policy.load(std::memory_order_relaxed) == QueueOverflowPolicy::Block){
+            while(!m_ring.tryPush(msg, logLevel, timeNs)){
+                ::sched_yield();
+            }
+            return;
+        }
+        m_ring.header().dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    static void printError(const std::string& msg){
+        #if ENABLE_MULTITHREADING
+        std::lock_guard<std::mutex> lock(consoleMutex);
+        #endif
+        std::cout << "-----------\n" << msg << "\n-----------" << std::endl;
     }
+
+    inline static std::atomic<std::uint64_t> s_nextId{0};
+
+    std::atomic<LogLevel> m_logLevel;
+    std::atomic<QueueOverflowPolicy> m_policy{QueueOverflowPolicy::DropNewest};
+
+    std::string m_name;
+    int m_fd = -1;
+    void* m_base = nullptr;
+    std::size_t m_size = 0;
+    LogShmRing m_ring;
 };
 
-/* Derived Logger class to handle text logging (normal .log-files) */
-class CsvLogger : public Logger{
+// snapshot of what a LogShmWriter has done so far (see LogShmWriter::getStats)
+struct LogShmWriterStats{
+    std::size_t clients = 0;        // rings currently attached
+    std::size_t files = 0;          // log files currently open
+    std::uint64_t written = 0;      // entries written
+    std::uint64_t dropped = 0;      // entries discarded by clients because their ring was full
+    std::uint64_t lost = 0;         // incomplete entries skipped (process died while logging them)
+    std::uint64_t crashed = 0;      // clients which ended without shutting down their logger
+};
+
+/* Writer side of shared memory logging: finds the rings of all SharedTextLoggers of a channel (segments
+ * "/<channel>.<pid>.<n>" of the same user), drains them and writes their entries with one TextLogger per file
+ * - rings of the same file are merged in order of time (like thread buffers, see Logger::getQueueItem)
+ * - a client which has ended (or crashed) is drained as far as its entries are complete, then its segment is removed;
+ *   slots it had claimed but not published are skipped and reported in its file
+ * - only one writer per channel (flock on "/<channel>.writer"); it may be restarted at any time, clients keep
+ *   logging into their rings meanwhile
+ * poll, run and getStats have to be called from one thread */
+class LogShmWriter{
 public:
-    CsvLogger(std::string logFileName, bool logFileNameIsAbsolutePath=false)
-        :Logger(false){
-        // if no specific logFileName provided, use default
-        if(logFileName == ""){
-            logFileName = "csv0.csv";
+    // scanInterval: how often to look for new and ended clients
+    LogShmWriter(const std::string& channel="logger", std::chrono::milliseconds scanInterval=std::chrono::milliseconds(100))
+        :m_channel(channel), m_scanInterval(scanInterval)
+    {}
+
+    ~LogShmWriter(){
+        // rings of running clients are kept, next writer continues with them
+        for(auto& client : m_clients){
+            detach(*client, false);
+        }
+        m_files.clear();
+        if(m_lockFd >= 0){
+            ::close(m_lockFd);
         }
+    }
 
-        // if logfile has no file extension, add it
-        if(logFileName.substr(logFileName.size()-4, 4) != ".csv"){
-            logFileName += ".csv";
+    LogShmWriter(const LogShmWriter&) = delete;
+    LogShmWriter& operator=(const LogShmWriter&) = delete;
+
+    // becomes writer of the channel; false if another writer already runs (or shared memory is not available)
+    bool open(){
+        if(m_lockFd >= 0){
+            return true;
+        }
+        if(m_channel.empty() || m_channel.find('/') != std::string::npos){
+            return false;
+        }
+        std::string name = "/" + m_channel + ".writer";
+        int fd = ::shm_open(name.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+        if(fd < 0){
+            return false;
+        }
+        if(::flock(fd, LOCK_EX | LOCK_NB) != 0){
+            ::close(fd);
+            return false;
         }
+        m_lockFd = fd;
+        return true;
+    }
 
-        setup(logFileName, logFileNameIsAbsolutePath);
+    // called for every file the writer opens, before first entry of a client is written (e.g. rotation policy,
+    // compression, time index or time stamp format); files are buffered (64 KiB, 100 ms) unless setup changes that
+    // loggers must not be handed over to a LogThreader, writer writes them itself
+    void setFileSetup(std::function<void(TextLogger&)> setup){
+        m_fileSetup = std::move(setup);
     }
 
-    ~CsvLogger(){
+    // one round: looks for new and ended clients (every scanInterval), writes what has been logged since last round
+    // and flushes files according to their flush policy; returns amount of entries written
+    std::size_t poll(){
+        if(m_lockFd < 0){
+            return 0;
+        }
 
-        std::string infoMsg = "CsvLogger has been shut down";
-        printToConsole(infoMsg);
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        if(now - m_lastScan >= m_scanInterval){
+            m_lastScan = now;
+            scan();
+        }
 
-    }
+        std::size_t written = 0;
+        for(auto& file : m_files){
+            written += drain(*file);
+            file->logger->m_sink.commit();
+            file->logger->m_sink.flushIfDue();
+        }
+        m_stats.written += written;
 
-    // create log entries
-    // write entries to m_logEntries
-    void log(const std::string &logEntry){
+        removeEnded();
+        return written;
+    }
 
-        std::unique_ptr<LogEntry> entry = std::make_unique<LogEntry>(logEntry);
-        if(isHandledByThreader()){
-            #if ENABLE_MULTITHREADING
-            // write to queue
-            m_queueMutex.lock();
-            m_logEntries.push(move(entry));
-            m_queueMutex.unlock();
-            #endif
-        } else {
-            // write to log
-            print(move(entry));
+    // polls until isRunning gets false, sleeping idleSleep whenever a round had nothing to write
+    // (so entries reach their file within about idleSleep plus flush delay); writes what is left before returning
+    void run(const std::atomic<bool>& isRunning, std::chrono::microseconds idleSleep=std::chrono::microseconds(1000)){
+        struct timespec pause{(time_t)(idleSleep.count() / 1000000), (long)(idleSleep.count() % 1000000) * 1000};
+        while(isRunning.load(std::memory_order_acquire)){
+            if(poll() == 0){
+                nanosleep(&pause, nullptr);
+            }
         }
+        while(poll() > 0){}
     }
 
-    void log(const char* logEntry){
-        std::string msg(logEntry);      // convert char* to std::string
-        log(msg);
+    LogShmWriterStats getStats(){
+        LogShmWriterStats stats = m_stats;
+        stats.clients = m_clients.size();
+        stats.files = m_files.size();
+        for(auto& client : m_clients){
+            stats.dropped += client->ring.header().dropped.load(std::memory_order_relaxed);
+            stats.lost += client->ring.getLost();
+        }
+        return stats;
     }
 
 private:
+    struct File;
 
-    // construct entry, give command to write to console and/or file
-    void print(std::unique_ptr<LogEntry> entry, bool enforceConsoleWriting=false) override{
+    struct Client{
+        std::string name;           // segment name (without leading '/')
+        int fd = -1;
+        void* base = nullptr;
+        std::size_t size = 0;
+        LogShmRing ring;
+        File* file = nullptr;
+        bool hasEnded = false;      // closed its logger or process is gone: nothing gets published anymore
+        bool hasCrashed = false;    // process is gone without closing its logger
+    };
 
-        entry->constructEntry();
-        std::string msg = entry->getEntry();
+    struct File{
+        std::string path;
+        std::unique_ptr<TextLogger> logger;
+        std::vector<Client*> clients;
+    };
 
-        // check amount of columns
-        if(m_nColumns == 0){    // first time
-            for (int i = 0; i < msg.size(); ++i){
-                if(msg[i] == ',') ++m_nColumns;
-            }
-            ++m_nColumns;   // there is always one more column than semicolons
+    // entries written per file and round, so that a busy file can't hold up the others
+    static constexpr std::size_t s_batchSize = 4096;
 
+    // checks clients for their end, attaches rings of new clients
+    void scan(){
+        for(auto& client : m_clients){
+            if(!client->hasEnded){
+                checkEnded(*client);
+            }
         }
-        else {  // every other time
-            int count = 1;  // there is always one more column than semicolons
-            for (int i = 0; i < msg.size(); ++i){
-                if(msg[i] == ',') ++count;
+
+        std::error_code ec;
+        for(const fs::directory_entry& entry : fs::directory_iterator("/dev/shm", ec)){
+            std::string name = entry.path().filename().string();
+            if(!isRingName(name)){
+                continue;
             }
-            if(count != m_nColumns){
-                std::string warningMsg = "WARNING! Amount of columns (" + std::to_string(count) + ") does not correspond to columns in first row (" + std::to_string(m_nColumns) + ")";
-                printToConsole(warningMsg);
+            bool isAttached = false;
+            for(auto& client : m_clients){
+                isAttached = isAttached || client->name == name;
+            }
+            if(!isAttached){
+                attach(name);
             }
         }
+    }
 
-        if(enforceConsoleWriting) printToConsole(msg);
+    // "<channel>.<pid>.<n>"
+    bool isRingName(const std::string& name) const {
+        if(name.size() <= m_channel.size() + 1 || name.compare(0, m_channel.size(), m_channel) != 0 || name[m_channel.size()] != '.'){
+            return false;
+        }
+        std::size_t dots = 0;
+        for(std::size_t i = m_channel.size() + 1; i < name.size(); ++i){
+            if(name[i] == '.'){
+                if(name[i - 1] == '.' || ++dots > 1) return false;
+            }
+            else if(!std::isdigit((unsigned char)name[i])){
+                return false;
+            }
+        }
+        return dots == 1 && name.back() != '.';
+    }
 
-        printToFile(msg);
+    void checkEnded(Client& client){
+        if(client.ring.header().state.load(std::memory_order_acquire) == LogShmRing::Closed){
+            client.hasEnded = true;
+        }
+        // flock of client is released by kernel when its process ends
+        else if(::flock(client.fd, LOCK_EX | LOCK_NB) == 0){
+            client.hasEnded = true;
+            client.hasCrashed = true;
+        }
     }
 
-    // amount of columns; gets set on first entry according to amount of semicolons
-    int m_nColumns = 0;
-};
+    void attach(const std::string& name){
+        std::string shmName = "/" + name;
+        int fd = ::shm_open(shmName.c_str(), O_RDWR | O_CLOEXEC, 0);
+        if(fd < 0){
+            return;
+        }
+        struct stat st;
+        if(::fstat(fd, &st) != 0 || st.st_uid != ::geteuid()){
+            ::close(fd);
+            return;
+        }
 
-#if ENABLE_MULTITHREADING
-/* Class to handle multiple log-files in single thread */
-class LogThreader {
-public:
-    LogThreader(){
-        m_loggerRunning = true;
-        consoleMutex.lock();
-        std::cout << "LogThreader INFO: starting threader from thread id " << std::this_thread::get_id() << std::endl;
-        consoleMutex.unlock();
-        m_thread = std::thread(&LogThreader::logging, this);
-    }
+        std::unique_ptr<Client> client = std::make_unique<Client>();
+        client->name = name;
+        client->fd = fd;
+        client->size = (std::size_t)st.st_size;
+        bool isOwnerGone = ::flock(fd, LOCK_EX | LOCK_NB) == 0;
 
-    ~LogThreader(){
-        m_loggerRunning = false;
-        m_thread.join();   // wait for logging method to finish
-        consoleMutex.lock();
-        std::cout << "LogThreader INFO: threader has been shut down" << std::endl;
-        consoleMutex.unlock();
-    }
+        void* base = client->size >= sizeof(LogShmRing::Header) ? ::mmap(nullptr, client->size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) : MAP_FAILED;
+        client->base = base != MAP_FAILED ? base : nullptr;
+        if(client->base == nullptr || !client->ring.attach(client->base, client->size) || client->ring.header().path[0] != '/'){
+            // client died while setting up ring (or segment is not a ring); removed once it is old enough
+            detach(*client, isOwnerGone && std::time(nullptr) - st.st_mtime > 2);
+            return;
+        }
 
-    // add new logger to be handled
-    void addLogger(std::shared_ptr<Logger> logger){
-        m_handledLoggers.push_back(logger);
-        logger->m_isHandledByThreader = true;
+        client->hasEnded = isOwnerGone;
+        client->hasCrashed = isOwnerGone && client->ring.header().state.load(std::memory_order_acquire) != LogShmRing::Closed;
+        client->file = &fileFor(client->ring.header().path);
+        client->file->clients.push_back(client.get());
+        m_clients.push_back(std::move(client));
+    }
 
-        std::string msgString = "Logger is now handled by LogThreader in separate thread";
-        
-        // if csv file write to console only
-        if(logger->m_logFilePath.substr(logger->m_logFilePath.size()-4, 4) == ".csv"){
-            logger->printToConsole(msgString);
+    File& fileFor(const std::string& path){
+        for(auto& file : m_files){
+            if(file->path == path){
+                return *file;
+            }
         }
-        if(logger->m_logFilePath.substr(logger->m_logFilePath.size()-4, 4) == ".log"){
-            std::unique_ptr<LogEntryText> msg = std::make_unique<LogEntryText>(LogLevel::Info, msgString);
-            logger->print(move(msg));
+
+        std::unique_ptr<File> file = std::make_unique<File>();
+        file->path = path;
+        file->logger = std::make_unique<TextLogger>(path, LogLevel::Debug, true);
+        FlushPolicy policy;
+        policy.bufferSize = 64 << 10;
+        policy.maxDelay = std::chrono::milliseconds(100);
+        file->logger->setFlushPolicy(policy);
+        file->logger->m_sink.setGroupCommit(true);
+        if(m_fileSetup){
+            m_fileSetup(*file->logger);
         }
+        m_files.push_back(std::move(file));
+        return *m_files.back();
     }
 
-private:
-    // runs in separate thread; continuously writes entries of m_logEntries to file and/or console
-    void logging(){
-
-        consoleMutex.lock();
-        std::cout << "LogThreader INFO: logging on thread id " << std::this_thread::get_id() << std::endl;
-        consoleMutex.unlock();
+    // oldest complete entry of client
+    const LogShmRing::Slot* front(Client& client){
+        const LogShmRing::Slot* slot = client.ring.front();
+        while(slot == nullptr && client.hasEnded && client.ring.skipClaimed()){
+            slot = client.ring.front();
+        }
+        return slot;
+    }
 
-        while(true){
-            bool canExit = !m_loggerRunning;    // if logger is still running, no chance for exit
+    // writes entries of all clients of file, oldest first
+    std::size_t drain(File& file){
+        std::size_t written = 0;
+        while(written < s_batchSize){
+            Client* oldest = nullptr;
+            const LogShmRing::Slot* oldestSlot = nullptr;
+            std::int64_t secondOldest = INT64_MAX;
+            for(Client* client : file.clients){
+                const LogShmRing::Slot* slot = front(*client);
+                if(slot == nullptr){
+                    continue;
+                }
+                if(oldestSlot == nullptr || slot->timeNs < oldestSlot->timeNs){
+                    if(oldestSlot != nullptr){
+                        secondOldest = oldestSlot->timeNs;
+                    }
+                    oldest = client;
+                    oldestSlot = slot;
+                }
+                else if(slot->timeNs < secondOldest){
+                    secondOldest = slot->timeNs;
+                }
+            }
+            if(oldestSlot == nullptr){
+                break;
+            }
 
-            for(int i = 0; i < m_handledLoggers.size(); ++i){
+            // entries of oldest ring can be taken without looking at the others as long as they are older than
+            // the oldest entry of all other rings (entries published meanwhile are missed, order is only approximate)
+            do{
+                oldest->ring.read(oldestSlot, m_message);
+                LogLevel logLevel = oldestSlot->level <= LogLevel::Debug ? (LogLevel)oldestSlot->level : LogLevel::Info;
+                file.logger->logAt(m_message, logLevel, oldestSlot->timeNs);
+                oldest->ring.popFront();
+                ++written;
+            } while(written < s_batchSize && (oldestSlot = front(*oldest)) != nullptr && oldestSlot->timeNs <= secondOldest);
+        }
+        return written;
+    }
 
-                // do one item per queue per iteration, so that every logger gets processed equally
-                int size = m_handledLoggers[i]->getQueueSize();
-                if(size > 0){
-                    std::unique_ptr<LogEntry> entry = m_handledLoggers[i]->getQueueItem();
+    // removes clients which have ended and been drained, and files without clients
+    void removeEnded(){
+        for(auto it = m_clients.begin(); it != m_clients.end();){
+            Client& client = **it;
+            if(!client.hasEnded || !client.ring.isEmpty()){
+                ++it;
+                continue;
+            }
 
-                    // wirte to console and/or file
-                    m_handledLoggers[i]->print(move(entry));
-                    size--;
+            LogShmRing::Header& header = client.ring.header();
+            std::string process = "process " + std::to_string(header.pid);
+            std::uint64_t dropped = header.dropped.load(std::memory_order_relaxed);
+            std::uint64_t lost = client.ring.getLost();
+            if(dropped > 0){
+                client.file->logger->log(process + " discarded " + std::to_string(dropped) + " entries because its shared memory ring was full", LogLevel::Warning);
+            }
+            if(client.hasCrashed || lost > 0){
+                std::string msg = process + (client.hasCrashed ? " ended without shutting down its logger" : " wrote invalid entries");
+                if(lost > 0){
+                    msg += " (" + std::to_string(lost) + " incomplete entries skipped)";
                 }
-                if(size > 0) canExit = false;   // if m_loggerRunning is false, then even if only one logger has some items in it's queue, a new iteration is needed
+                client.file->logger->log(msg, LogLevel::Warning);
             }
+            m_stats.dropped += dropped;
+            m_stats.lost += lost;
+            m_stats.crashed += client.hasCrashed ? 1 : 0;
 
-            if(canExit){
-                break;
-            }
+            std::vector<Client*>& clients = client.file->clients;
+            clients.erase(std::find(clients.begin(), clients.end(), &client));
+            detach(client, true);
+            it = m_clients.erase(it);
+        }
+
+        // loggers write their shut down message and close the file
+        m_files.erase(std::remove_if(m_files.begin(), m_files.end(), [](const std::unique_ptr<File>& file){
+            return file->clients.empty();
+        }), m_files.end());
+    }
+
+    void detach(Client& client, bool remove){
+        if(client.base != nullptr){
+            ::munmap(client.base, client.size);
+            client.base = nullptr;
+        }
+        if(remove){
+            ::shm_unlink(("/" + client.name).c_str());
         }
+        ::close(client.fd);
+        client.fd = -1;
     }
 
-    bool m_loggerRunning;                   // is set to true by constructor and to false by destructor; keeps logging() function running 
+    std::string m_channel;
+    std::chrono::milliseconds m_scanInterval;
+    std::chrono::steady_clock::time_point m_lastScan{};
+    int m_lockFd = -1;
 
-    std::thread m_thread;                   // logging thread: started in constructor, joined in destructor
+    std::function<void(TextLogger&)> m_fileSetup;
 
-    std::vector<std::shared_ptr<Logger>> m_handledLoggers;
+    std::vector<std::unique_ptr<File>> m_files;
+    std::vector<std::unique_ptr<Client>> m_clients;
+
+    std::string m_message;      // reused for every entry
+    LogShmWriterStats m_stats;
 };
 #endif
 
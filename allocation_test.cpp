@@ -0,0 +1,135 @@
+/*
+ * allocation_test.cpp
+ *
+ * checks that logging does not allocate once loggers have warmed up (entries come from pools and keep their buffers)
+ * operator new/delete are replaced, so that every heap allocation of the process is counted
+ *
+ * usage:
+ *   allocation_test            returns 0 if no scenario allocated, 1 otherwise
+ */
+
+#include <iostream>
+#include <string>
+#include <cstdlib>
+#include <cstddef>
+#include <new>
+#include <atomic>
+#include <functional>
+
+#include "Logger.hpp"
+
+static std::atomic<bool> s_isCounting{false};
+static std::atomic<std::uint64_t> s_allocations{0};
+
+static void* allocate(std::size_t size, std::size_t alignment){
+    if(s_isCounting.load(std::memory_order_relaxed)){
+        s_allocations.fetch_add(1, std::memory_order_relaxed);
+    }
+    size = size == 0 ? 1 : size;
+    void* ptr = alignment <= alignof(std::max_align_t) ? std::malloc(size) : std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+    if(ptr == nullptr){
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void* operator new(std::size_t size){ return allocate(size, 0); }
+void* operator new[](std::size_t size){ return allocate(size, 0); }
+void* operator new(std::size_t size, std::align_val_t alignment){ return allocate(size, (std::size_t)alignment); }
+void* operator new[](std::size_t size, std::align_val_t alignment){ return allocate(size, (std::size_t)alignment); }
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept { std::free(ptr); }
+
+// entry pools grow until they hold as many entries as are in flight at once (up to queue capacity), so warm-up
+// has to be a burst as large as the measured one
+static const std::size_t s_warmUp = 20000;
+static const std::size_t s_measured = 20000;
+
+// runs logCall warm-up times, then counts allocations of measured calls (and of writing them, see waitWritten)
+static bool check(const std::string& name, const std::function<void(std::size_t)>& logCall, const std::function<void()>& waitWritten){
+    for(std::size_t i = 0; i < s_warmUp; ++i){
+        logCall(i);
+    }
+    waitWritten();
+
+    s_allocations.store(0);
+    s_isCounting.store(true);
+    for(std::size_t i = 0; i < s_measured; ++i){
+        logCall(i);
+    }
+    waitWritten();
+    s_isCounting.store(false);
+
+    std::uint64_t allocations = s_allocations.load();
+    std::cout << name << ": " << allocations << " allocations in " << s_measured << " log calls" << std::endl;
+    return allocations == 0;
+}
+
+#if ENABLE_MULTITHREADING
+// waits until LogThreader has written everything logged so far (sink stats, as getStats() copies histograms)
+static std::function<void()> writtenBy(std::shared_ptr<Logger> logger, const std::uint64_t& logged){
+    return [logger, &logged](){
+        while(logger->getSinkStats().entries < logged){
+            std::this_thread::yield();
+        }
+    };
+}
+#endif
+
+int main(){
+
+    bool isOk = true;
+    std::function<void()> none = [](){};
+
+    std::shared_ptr<TextLogger> textLogger = std::make_shared<TextLogger>("alloc_text.log", LogLevel::Debug);
+    std::shared_ptr<CsvLogger> csvLogger = std::make_shared<CsvLogger>("alloc_csv.csv");
+
+    isOk &= check("sync text", [&](std::size_t i){
+        textLogger->log("message of constant length", LogLevel::Info);
+        textLogger->log<LogLevel::Debug>("formatted {:6d} {:.3f}", (int)(i % 100000), 0.5);
+    }, none);
+
+    isOk &= check("sync csv", [&](std::size_t){
+        csvLogger->log("1.5,2.5,3.5");
+    }, none);
+
+    isOk &= check("sync deferred", [&](std::size_t i){
+        LOG_DEFERRED(textLogger, LogLevel::Info, "deferred %d of %s", (int)i, "run");
+    }, none);
+
+    #if ENABLE_MULTITHREADING
+    {
+        LogThreader threader;
+        threader.addLogger(textLogger);
+        threader.addLogger(csvLogger);
+
+        std::uint64_t textLogged = textLogger->getSinkStats().entries;
+        std::uint64_t csvLogged = csvLogger->getSinkStats().entries;
+
+        isOk &= check("threaded text", [&](std::size_t i){
+            textLogger->log("message of constant length", LogLevel::Info);
+            textLogger->log<LogLevel::Debug>("formatted {:6d} {:.3f}", (int)(i % 100000), 0.5);
+            textLogged += 2;
+        }, writtenBy(textLogger, textLogged));
+
+        isOk &= check("threaded csv", [&](std::size_t){
+            csvLogger->log("1.5,2.5,3.5");
+            ++csvLogged;
+        }, writtenBy(csvLogger, csvLogged));
+
+        isOk &= check("threaded deferred", [&](std::size_t i){
+            LOG_DEFERRED(textLogger, LogLevel::Info, "deferred %d of %s", (int)i, "run");
+            ++textLogged;
+        }, writtenBy(textLogger, textLogged));
+    }
+    #endif
+
+    std::cout << (isOk ? "no allocations while logging" : "FAILED: logging allocated") << std::endl;
+    return isOk ? 0 : 1;
+}
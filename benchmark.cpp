@@ -0,0 +1,291 @@
+/*
+ * benchmark.cpp
+ *
+ * measures throughput and per-call latency of log() for different configurations
+ *
+ * usage:
+ *   benchmark [--threads 1,2,4] [--sizes 16,128,1024] [--messages N] [--modes sync,threaded] [--kinds text,csv]
+ *             [--console] [--async-io] [--json] [--out file]
+ *
+ * --console adds runs with console printing: "direct" (written by calling thread) and "async" (LogConsoleSink)
+ * --async-io adds runs with asynchronous file output (Logger::enableAsyncIo, io_uring or pwrite pool)
+ *
+ * every combination is run once; one result line per run is written as csv (default) or json lines
+ * latencies are collected per producer thread in a LatencyHistogram (p50, p99, p99.9 are bucket upper bounds)
+ * synchronous loggers must only be used by one thread, so sync runs are done with one thread only
+ */
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <thread>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+
+#include "Logger.hpp"
+
+namespace fs = std::filesystem;
+
+struct BenchConfig{
+    bool threaded = true;
+    bool csv = false;
+    std::string console = "off";        // off, direct or async
+    bool asyncIo = false;
+    int nThreads = 1;
+    std::size_t msgSize = 128;
+    std::size_t nMessages = 100000;     // per thread
+};
+
+struct BenchResult{
+    double seconds = 0;                 // from first call until everything has been written
+    double producerSeconds = 0;         // until last log() call returned
+    std::uint64_t bytes = 0;
+    LatencyHistogram latency;
+};
+
+static std::uint64_t nowNs(){
+    return (std::uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// message of given size; csv messages consist of comma separated numbers
+static std::string makeMessage(const BenchConfig& config, int threadId){
+    std::string msg;
+    if(config.csv){
+        while(msg.size() < config.msgSize){
+            msg += std::to_string(threadId) + "." + std::to_string(msg.size()) + ",";
+        }
+    }
+    else{
+        msg = "thread " + std::to_string(threadId) + " ";
+        while(msg.size() < config.msgSize){
+            msg += "abcdefghijklmnopqrstuvwxyz"[msg.size() % 26];
+        }
+    }
+    msg.resize(config.msgSize);
+    return msg;
+}
+
+template<typename LoggerType, typename LogCall>
+static BenchResult runWith(std::shared_ptr<LoggerType> logger, const BenchConfig& config, LogCall logCall){
+    BenchResult result;
+    std::vector<LatencyHistogram> histograms(config.nThreads);
+
+    std::uint64_t start = nowNs();
+    std::uint64_t producersDone;
+    {
+        #if ENABLE_MULTITHREADING
+        std::unique_ptr<LogThreader> threader;
+        if(config.threaded){
+            threader = std::make_unique<LogThreader>();
+            threader->addLogger(logger);
+            start = nowNs();
+        }
+        #endif
+
+        auto produce = [&](int threadId){
+            std::string msg = makeMessage(config, threadId);
+            LatencyHistogram& histogram = histograms[threadId];
+            for(std::size_t i = 0; i < config.nMessages; ++i){
+                std::uint64_t before = nowNs();
+                logCall(*logger, msg);
+                histogram.add(nowNs() - before);
+            }
+        };
+
+        if(config.nThreads == 1){
+            produce(0);
+        }
+        else{
+            std::vector<std::thread> threads;
+            for(int t = 0; t < config.nThreads; ++t){
+                threads.emplace_back(produce, t);
+            }
+            for(std::thread& thread : threads){
+                thread.join();
+            }
+        }
+        producersDone = nowNs();
+        // threader drains and flushes remaining entries when it gets destroyed
+    }
+    std::uint64_t end = nowNs();
+
+    result.seconds = (double)(end - start) * 1e-9;
+    result.producerSeconds = (double)(producersDone - start) * 1e-9;
+    result.bytes = logger->getSinkStats().bytes;
+    for(LatencyHistogram& histogram : histograms){
+        result.latency.merge(histogram);
+    }
+    return result;
+}
+
+static BenchResult run(const BenchConfig& config, const std::string& fileName){
+    fs::remove(fs::current_path() / "log" / fileName);
+
+    if(config.csv){
+        std::shared_ptr<CsvLogger> logger = std::make_shared<CsvLogger>(fileName);
+        if(config.asyncIo){
+            logger->enableAsyncIo();
+        }
+        return runWith(logger, config, [](CsvLogger& csvLogger, const std::string& msg){
+            csvLogger.log(msg);
+        });
+    }
+
+    std::shared_ptr<TextLogger> logger = std::make_shared<TextLogger>(fileName, LogLevel::Debug, false, config.console != "off");
+    if(config.asyncIo){
+        logger->enableAsyncIo();
+    }
+    #if ENABLE_MULTITHREADING
+    if(config.console == "async"){
+        logger->enableAsyncConsole();
+    }
+    #endif
+    return runWith(logger, config, [](TextLogger& textLogger, const std::string& msg){
+        textLogger.log(msg, LogLevel::Info);
+    });
+}
+
+static std::vector<std::string> split(const std::string& list){
+    std::vector<std::string> items;
+    std::stringstream stream(list);
+    std::string item;
+    while(std::getline(stream, item, ',')){
+        if(!item.empty()){
+            items.push_back(item);
+        }
+    }
+    return items;
+}
+
+static void printUsage(){
+    std::cerr << "usage: benchmark [--threads 1,2,4] [--sizes 16,128,1024] [--messages N] [--modes sync,threaded] [--kinds text,csv]" << std::endl
+              << "                 [--console] [--async-io] [--json] [--out file]" << std::endl;
+}
+
+int main(int argc, char* argv[]){
+
+    std::vector<int> threadCounts = {1, 2, 4};
+    std::vector<std::size_t> sizes = {16, 128, 1024};
+    std::vector<std::string> modes = {"sync", "threaded"};
+    std::vector<std::string> kinds = {"text", "csv"};
+    std::vector<std::string> consoleSettings = {"off"};
+    std::vector<std::string> ioSettings = {"sync"};
+    std::size_t nMessages = 100000;
+    bool json = false;
+    std::string outPath;
+
+    for(int i = 1; i < argc; ++i){
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if(arg == "--threads" && hasValue){
+            threadCounts.clear();
+            for(const std::string& item : split(argv[++i])) threadCounts.push_back(std::max(1, std::stoi(item)));
+        }
+        else if(arg == "--sizes" && hasValue){
+            sizes.clear();
+            for(const std::string& item : split(argv[++i])) sizes.push_back((std::size_t)std::stoul(item));
+        }
+        else if(arg == "--messages" && hasValue){
+            nMessages = (std::size_t)std::stoul(argv[++i]);
+        }
+        else if(arg == "--modes" && hasValue){
+            modes = split(argv[++i]);
+        }
+        else if(arg == "--kinds" && hasValue){
+            kinds = split(argv[++i]);
+        }
+        else if(arg == "--console"){
+            consoleSettings = {"off", "direct", "async"};
+        }
+        else if(arg == "--async-io"){
+            ioSettings = {"sync", "async"};
+        }
+        else if(arg == "--json"){
+            json = true;
+        }
+        else if(arg == "--out" && hasValue){
+            outPath = argv[++i];
+        }
+        else{
+            printUsage();
+            return 1;
+        }
+    }
+
+    std::ofstream outFile;
+    if(!outPath.empty()){
+        outFile.open(outPath, std::ios::out);
+        if(!outFile.is_open()){
+            std::cerr << "could not open " << outPath << std::endl;
+            return 1;
+        }
+    }
+    std::ostream& out = outPath.empty() ? std::cout : outFile;
+
+    if(!json){
+        out << "mode,kind,console,io,threads,msg_size,messages,seconds,producer_seconds,msgs_per_s,bytes_per_s,p50_ns,p99_ns,p999_ns,max_ns" << std::endl;
+    }
+
+    for(const std::string& mode : modes){
+        for(const std::string& kind : kinds){
+            for(const std::string& console : consoleSettings){
+                // csv loggers never print entries to console
+                if(console != "off" && kind == "csv"){
+                    continue;
+                }
+                for(const std::string& io : ioSettings){
+                    for(int nThreads : threadCounts){
+                        if(mode == "sync" && nThreads > 1){
+                            continue;
+                        }
+                        for(std::size_t size : sizes){
+                            BenchConfig config;
+                            config.threaded = mode == "threaded";
+                            config.csv = kind == "csv";
+                            config.console = console;
+                            config.asyncIo = io == "async";
+                            config.nThreads = nThreads;
+                            config.msgSize = size;
+                            config.nMessages = nMessages;
+
+                            #if !ENABLE_MULTITHREADING
+                            if(config.threaded) continue;
+                            #endif
+
+                            std::string fileName = "bench_" + mode + "_" + io + "_" + std::to_string(nThreads) + "_" + std::to_string(size) + (config.csv ? ".csv" : ".log");
+                            BenchResult result = run(config, fileName);
+                            fs::remove(fs::current_path() / "log" / fileName);
+
+                            std::uint64_t total = (std::uint64_t)nThreads * nMessages;
+                            double msgsPerSecond = result.seconds > 0 ? (double)total / result.seconds : 0;
+                            double bytesPerSecond = result.seconds > 0 ? (double)result.bytes / result.seconds : 0;
+
+                            if(json){
+                                out << "{\"mode\":\"" << mode << "\",\"kind\":\"" << kind << "\",\"console\":\"" << console << "\",\"io\":\"" << io << "\""
+                                    << ",\"threads\":" << nThreads << ",\"msg_size\":" << size << ",\"messages\":" << total
+                                    << ",\"seconds\":" << result.seconds << ",\"producer_seconds\":" << result.producerSeconds
+                                    << ",\"msgs_per_s\":" << (std::uint64_t)msgsPerSecond << ",\"bytes_per_s\":" << (std::uint64_t)bytesPerSecond
+                                    << ",\"p50_ns\":" << result.latency.percentile(0.5) << ",\"p99_ns\":" << result.latency.percentile(0.99)
+                                    << ",\"p999_ns\":" << result.latency.percentile(0.999) << ",\"max_ns\":" << result.latency.max() << "}" << std::endl;
+                            }
+                            else{
+                                out << mode << "," << kind << "," << console << "," << io << "," << nThreads << "," << size << "," << total << ","
+                                    << result.seconds << "," << result.producerSeconds << ","
+                                    << (std::uint64_t)msgsPerSecond << "," << (std::uint64_t)bytesPerSecond << ","
+                                    << result.latency.percentile(0.5) << "," << result.latency.percentile(0.99) << ","
+                                    << result.latency.percentile(0.999) << "," << result.latency.max() << std::endl;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    return 0;
+}
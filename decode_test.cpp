@@ -0,0 +1,99 @@
+/*
+ * decode_test.cpp
+ *
+ * checks that binary log files get decoded correctly, also if their format strings are unusual or records are corrupt
+ * records are composed by hand (like a crafted or damaged file would be) and read back with BinaryLogDecoder
+ *
+ * usage:
+ *   decode_test            returns 0 if every line was decoded as expected, 1 otherwise
+ */
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "LogReader.hpp"
+
+struct DecodeCase{
+    std::string fmt;
+    std::string args;           // encoded arguments (LogRecordCodec::appendArg)
+    std::string expected;       // text after prefix of line
+};
+
+template<typename... Args>
+static std::string encode(const Args&... args){
+    std::string out;
+    LogRecordCodec::beginRecord(out, LogRecordCodec::Entry, LogLevel::Info, 0, 0);
+    (LogRecordCodec::appendArg(out, args), ...);
+    return out.substr(sizeof(LogRecordCodec::Header));
+}
+
+static std::string record(LogRecordCodec::RecordType type, std::uint32_t fmtId, const std::string& payload){
+    std::string out;
+    LogRecordCodec::beginRecord(out, type, LogLevel::Info, fmtId, 0);
+    out += payload;
+    LogRecordCodec::finishRecord(out);
+    return out;
+}
+
+int main(){
+
+    std::string longStr(300, 'x');
+    std::string corrupt = encode(5);
+    corrupt[0] = (char)0x7F;       // unknown tag
+
+    std::vector<DecodeCase> cases = {
+        {"[%*d]", encode(5, 42), "[   42]"},
+        {"[%*d]", encode(-5, 42), "[42   ]"},
+        {"[%-*d]", encode(5, 42), "[42   ]"},
+        {"[%.*s]", encode(3, "abcdef"), "[abc]"},
+        {"[%*.*f]", encode(8, 2, 3.14159), "[    3.14]"},
+        {"[%.*d]", encode(-1, 42), "[42]"},
+        {"[%*d] %d", encode("str", 42, 7), "[<?>] 7"},
+        {"[%*d]", encode(5), "[<?>]"},
+        {"[%*d]", corrupt, "[<?>]"},
+        {"[%*s]", encode(1000000000, "x"), "[" + std::string(0xFFFF - 1, ' ') + "x]"},
+        {"[%s]", encode(longStr), "[" + longStr + "]"},
+        {"[%-10s]", encode(longStr), "[" + longStr + "]"},
+        {"[%-310s]", encode(longStr), "[" + longStr + "          ]"},
+        {"[%400d]", encode(1), "[" + std::string(399, ' ') + "1]"},
+        {"[%999999999d]", encode(1), "[<?>]"},
+    };
+
+    const std::string path = "decode_test.blog";
+    {
+        std::ofstream file(path, std::ios::out | std::ios::binary | std::ios::trunc);
+        file.write(LogRecordCodec::s_magic, sizeof(LogRecordCodec::s_magic));
+        for(std::size_t i = 0; i < cases.size(); ++i){
+            file << record(LogRecordCodec::FormatDef, (std::uint32_t)i, cases[i].fmt);
+            file << record(LogRecordCodec::Entry, (std::uint32_t)i, cases[i].args);
+        }
+    }
+
+    BinaryLogDecoder decoder;
+    if(!decoder.open(path)){
+        std::cout << "FAILED: could not open " << path << std::endl;
+        return 1;
+    }
+
+    bool isOk = true;
+    std::string line;
+    for(const DecodeCase& decodeCase : cases){
+        if(!decoder.next(line)){
+            std::cout << "FAILED: " << decodeCase.fmt << ": no line decoded" << std::endl;
+            return 1;
+        }
+        bool isMatch = line.size() >= decodeCase.expected.size()
+                       && line.compare(line.size() - decodeCase.expected.size(), std::string::npos, decodeCase.expected) == 0;
+        std::cout << decodeCase.fmt << ": " << (isMatch ? "ok" : "FAILED, got \"" + line + "\"") << std::endl;
+        isOk &= isMatch;
+    }
+    if(decoder.next(line) || decoder.isCorrupt()){
+        std::cout << "FAILED: unexpected data after last record" << std::endl;
+        isOk = false;
+    }
+
+    std::cout << (isOk ? "all records decoded" : "FAILED: decoding") << std::endl;
+    return isOk ? 0 : 1;
+}
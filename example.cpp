@@ -59,15 +59,19 @@ void testLoggerClass(){
     std::shared_ptr<CsvLogger> csvLogger = std::make_shared<CsvLogger>("kinState.csv");
     csvLogger->log("t,s,v,a");
 
+    // one csv logger with typed columns (amount of values gets checked at compile time)
+    std::shared_ptr<TypedCsvLogger<double, double, double, double>> typedCsvLogger = std::make_shared<TypedCsvLogger<double, double, double, double>>("kinStateTyped.csv", std::array<std::string_view, 4>{"t", "s", "v", "a"});
+
     /* TESTING */
     // test all three loggers simultaneously
     Timer timer;    // measure time until program is ready to continue with something else (-> displayed time is not time needed for logging)
     for(int i = 0; i < 10; ++i){
-        logger->log("Message " + std::to_string(i), LogLevel::Debug);
-        customLogger->log("Custom logger message " + std::to_string(i), LogLevel::Debug);
+        logger->log<LogLevel::Debug>("Message {}", i);
+        customLogger->log<LogLevel::Debug>("Custom logger message {}", i);
         customLogger->log("Custom logger message " + std::to_string(i), LogLevel::Debug, " ");
         customLogger->log("Custom logger message " + std::to_string(i), LogLevel::Debug, std::to_string(i/10.0));
         csvLogger->log("i,1,2,3");
+        typedCsvLogger->logRow(i / 1000.0, 1.0, 2.0, 3.0);
     }
     
     int t1 = timer.stop();
@@ -79,14 +83,16 @@ void testLoggerClass(){
     threader.addLogger(logger);
     threader.addLogger(customLogger);
     threader.addLogger(csvLogger);
+    threader.addLogger(typedCsvLogger);
 
     timer.start();
     for(int i = 10; i < 20; ++i){
-        logger->log("Message " + std::to_string(i), LogLevel::Debug);
-        customLogger->log("Custom logger message " + std::to_string(i), LogLevel::Debug);
+        logger->log<LogLevel::Debug>("Message {}", i);
+        customLogger->log<LogLevel::Debug>("Custom logger message {}", i);
         customLogger->log("Custom logger message " + std::to_string(i), LogLevel::Debug, " ");
         customLogger->log("Custom logger message " + std::to_string(i), LogLevel::Debug, std::to_string(i/10.0));
         csvLogger->log("i,1,2,3");
+        typedCsvLogger->logRow(i / 1000.0, 1.0, 2.0, 3.0);
     }
     
     int t2 = timer.stop();
@@ -0,0 +1,222 @@
+/*
+ * logtool.cpp
+ *
+ * command line tool for files written by Logger.hpp
+ *
+ * usage:
+ *   logtool decode <file.blog> [out.log]     converts binary log to normal .log-layout
+ *   logtool csv <file.ccol> [out.csv]        converts binary columnar file to csv
+ *   logtool recover <file.log> [out.log]     extracts complete lines of a (crashed) memory mapped log
+ *   logtool cat <file.lz4> [from] [to]       decompresses log file, optionally only entries of given time range
+ *                                            (time as "YYYY-mm-dd HH:MM:SS" in local time or as unix seconds)
+ *   logtool slice <file> [from] [to]         prints entries of given time range of .log or .csv file with time index
+ *                                            (<file>.idx), without reading the rest of the file
+ */
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <sstream>
+#include <iomanip>
+#include <ctime>
+
+#include "LogReader.hpp"
+
+int decode(int argc, char* argv[]){
+    if(argc < 3){
+        std::cerr << "usage: logtool decode <file.blog> [out.log]" << std::endl;
+        return 1;
+    }
+
+    BinaryLogDecoder decoder;
+    if(!decoder.open(argv[2])){
+        std::cerr << "could not open " << argv[2] << std::endl;
+        return 1;
+    }
+
+    std::ofstream outFile;
+    if(argc > 3){
+        outFile.open(argv[3], std::ios::out | std::ios::app);
+        if(!outFile.is_open()){
+            std::cerr << "could not open " << argv[3] << std::endl;
+            return 1;
+        }
+    }
+    std::ostream& out = argc > 3 ? outFile : std::cout;
+
+    std::string line;
+    while(decoder.next(line)){
+        out << line << '\n';
+    }
+
+    if(decoder.isCorrupt()){
+        std::cerr << "stopped at corrupt record" << std::endl;
+        return 2;
+    }
+    return 0;
+}
+
+int csv(int argc, char* argv[]){
+    if(argc < 3){
+        std::cerr << "usage: logtool csv <file.ccol> [out.csv]" << std::endl;
+        return 1;
+    }
+
+    ColumnarCsvReader reader;
+    if(!reader.open(argv[2])){
+        std::cerr << "could not open " << argv[2] << " (or not a .ccol-file)" << std::endl;
+        return 1;
+    }
+
+    if(argc > 3){
+        std::ofstream outFile(argv[3], std::ios::out);
+        if(!outFile.is_open()){
+            std::cerr << "could not open " << argv[3] << std::endl;
+            return 1;
+        }
+        reader.writeCsv(outFile);
+    }
+    else{
+        reader.writeCsv(std::cout);
+    }
+    return 0;
+}
+
+int recover(int argc, char* argv[]){
+    if(argc < 3){
+        std::cerr << "usage: logtool recover <file.log> [out.log]" << std::endl;
+        return 1;
+    }
+
+    CompleteLineReader reader;
+    if(!reader.open(argv[2])){
+        std::cerr << "could not open " << argv[2] << std::endl;
+        return 1;
+    }
+
+    std::ofstream outFile;
+    if(argc > 3){
+        outFile.open(argv[3], std::ios::out);
+        if(!outFile.is_open()){
+            std::cerr << "could not open " << argv[3] << std::endl;
+            return 1;
+        }
+    }
+    std::ostream& out = argc > 3 ? outFile : std::cout;
+
+    std::string_view line;
+    while(reader.next(line)){
+        out << line << '\n';
+    }
+
+    if(reader.skippedBytes() > 0){
+        std::cerr << "skipped " << reader.skippedBytes() << " bytes of incomplete entries" << std::endl;
+    }
+    return 0;
+}
+
+// parses "YYYY-mm-dd HH:MM:SS" (local time) or unix seconds into ns; returns false if neither
+bool parseTime(const std::string& text, std::int64_t& timeNs){
+    if(!text.empty() && text.find_first_not_of("0123456789") == std::string::npos){
+        timeNs = std::stoll(text) * 1000000000LL;
+        return true;
+    }
+
+    std::tm tm = {};
+    std::istringstream stream(text);
+    stream >> std::get_time(&tm, "%Y-%m-%d %H:%M:%S");
+    if(stream.fail()){
+        return false;
+    }
+    tm.tm_isdst = -1;
+    timeNs = (std::int64_t)std::mktime(&tm) * 1000000000LL;
+    return true;
+}
+
+int cat(int argc, char* argv[]){
+    if(argc < 3){
+        std::cerr << "usage: logtool cat <file.lz4> [from] [to]" << std::endl;
+        return 1;
+    }
+
+    std::int64_t fromNs = INT64_MIN;
+    std::int64_t toNs = INT64_MAX;
+    if((argc > 3 && !parseTime(argv[3], fromNs)) || (argc > 4 && !parseTime(argv[4], toNs))){
+        std::cerr << "time has to be given as \"YYYY-mm-dd HH:MM:SS\" or unix seconds" << std::endl;
+        return 1;
+    }
+    if(argc > 4){
+        toNs += 999999999;  // whole last second
+    }
+
+    CompressedLogReader reader;
+    if(!reader.open(argv[2])){
+        std::cerr << "could not open " << argv[2] << " (or not a compressed log)" << std::endl;
+        return 1;
+    }
+    if(!reader.hasFooter()){
+        std::cerr << "file has not been closed properly, index rebuilt from " << reader.nFrames() << " frames" << std::endl;
+    }
+
+    if(!reader.write(std::cout, fromNs, toNs)){
+        std::cerr << "stopped at corrupt frame" << std::endl;
+        return 2;
+    }
+    return 0;
+}
+
+int slice(int argc, char* argv[]){
+    if(argc < 3){
+        std::cerr << "usage: logtool slice <file> [from] [to]" << std::endl;
+        return 1;
+    }
+
+    std::int64_t fromNs = INT64_MIN;
+    std::int64_t toNs = INT64_MAX;
+    if((argc > 3 && !parseTime(argv[3], fromNs)) || (argc > 4 && !parseTime(argv[4], toNs))){
+        std::cerr << "time has to be given as \"YYYY-mm-dd HH:MM:SS\" or unix seconds" << std::endl;
+        return 1;
+    }
+    if(argc > 4){
+        toNs += 999999999;  // whole last second
+    }
+
+    IndexedLogReader reader;
+    if(!reader.open(argv[2])){
+        std::cerr << "could not open " << argv[2] << " (or its time index " << LogTimeIndex::pathOf(argv[2]) << ")" << std::endl;
+        return 1;
+    }
+
+    reader.write(std::cout, fromNs, toNs);
+    return 0;
+}
+
+int main(int argc, char* argv[]){
+
+    std::string command = argc > 1 ? argv[1] : "";
+
+    if(command == "decode"){
+        return decode(argc, argv);
+    }
+    if(command == "csv"){
+        return csv(argc, argv);
+    }
+    if(command == "recover"){
+        return recover(argc, argv);
+    }
+    if(command == "cat"){
+        return cat(argc, argv);
+    }
+    if(command == "slice"){
+        return slice(argc, argv);
+    }
+
+    std::cerr << "usage: logtool <command> ..." << std::endl
+              << "commands:" << std::endl
+              << "  decode <file.blog> [out.log]    convert binary log to text" << std::endl
+              << "  csv <file.ccol> [out.csv]       convert binary columnar file to csv" << std::endl
+              << "  recover <file.log> [out.log]    extract complete lines of memory mapped log" << std::endl
+              << "  cat <file.lz4> [from] [to]      decompress log (optionally only given time range)" << std::endl
+              << "  slice <file> [from] [to]        print given time range of log with time index" << std::endl;
+    return 1;
+}
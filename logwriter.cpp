@@ -0,0 +1,106 @@
+/*
+ * logwriter.cpp
+ *
+ * writer process for shared memory logging: writes the entries of all SharedTextLoggers of a channel to their files
+ *
+ * usage:
+ *   logwriter [--channel name] [--idle-us N] [--scan-ms N] [--sync-level error|warning|info|debug]
+ *
+ * runs until SIGINT or SIGTERM; clients keep logging into their rings meanwhile, the next writer continues with them
+ * --sync-level makes entries of that level or more severe durable (fdatasync, shared by all entries of a round)
+ */
+
+#include <iostream>
+#include <string>
+#include <atomic>
+#include <csignal>
+
+#include "Logger.hpp"
+
+static std::atomic<bool> s_isRunning{true};
+
+static void onSignal(int){
+    s_isRunning.store(false);
+}
+
+static bool parseLevel(const std::string& str, LogLevel& level){
+    for(LogLevel candidate : {LogLevel::Error, LogLevel::Warning, LogLevel::Info, LogLevel::Debug}){
+        std::string name;
+        logLevelToStr(name, candidate);
+        std::string lower;
+        for(char c : name) lower += (char)std::tolower((unsigned char)c);
+        if(str == lower){
+            level = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+static void printUsage(){
+    std::cerr << "usage: logwriter [--channel name] [--idle-us N] [--scan-ms N] [--sync-level error|warning|info|debug]" << std::endl;
+}
+
+int main(int argc, char* argv[]){
+
+    std::string channel = "logger";
+    long idleUs = 1000;
+    long scanMs = 100;
+    int syncLevel = -1;
+
+    for(int i = 1; i < argc; ++i){
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if(arg == "--channel" && hasValue){
+            channel = argv[++i];
+        }
+        else if(arg == "--idle-us" && hasValue){
+            idleUs = std::max(1L, std::stol(argv[++i]));
+        }
+        else if(arg == "--scan-ms" && hasValue){
+            scanMs = std::max(1L, std::stol(argv[++i]));
+        }
+        else if(arg == "--sync-level" && hasValue){
+            LogLevel level;
+            if(!parseLevel(argv[++i], level)){
+                printUsage();
+                return 1;
+            }
+            syncLevel = level;
+        }
+        else{
+            printUsage();
+            return 1;
+        }
+    }
+
+    LogShmWriter writer(channel, std::chrono::milliseconds(scanMs));
+    if(!writer.open()){
+        std::cerr << "could not become writer of channel " << channel << " (another writer running?)" << std::endl;
+        return 1;
+    }
+    if(syncLevel >= 0){
+        writer.setFileSetup([syncLevel](TextLogger& logger){
+            FlushPolicy policy;
+            policy.bufferSize = 64 << 10;
+            policy.maxDelay = std::chrono::milliseconds(100);
+            policy.syncLevel = syncLevel;
+            logger.setFlushPolicy(policy);
+        });
+    }
+
+    // buffered entries of the writer itself are saved if it crashes
+    LogCrashHandler::install();
+
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+
+    std::cout << "writing entries of channel " << channel << std::endl;
+    writer.run(s_isRunning, std::chrono::microseconds(idleUs));
+
+    LogShmWriterStats stats = writer.getStats();
+    std::cout << "written " << stats.written << " entries, dropped by clients " << stats.dropped
+              << ", incomplete " << stats.lost << ", crashed clients " << stats.crashed << std::endl;
+    return 0;
+}